@@ -0,0 +1,111 @@
+// idocohen963@gmail.com
+/**
+ * @file Autotune.hpp
+ * @brief Header file for the block-size autotuner and tuning profiles of the GEMM engine
+ *
+ * The best block sizes and micro-kernel depend on the cache hierarchy and
+ * vector units of the host, so DEFAULT_BLOCK_SIZES is only a reasonable
+ * starting point. autotune() times candidate configurations of the engine on
+ * this machine and applies the fastest; saveProfile() writes it to a small text
+ * file that later runs load at startup through the SQUAREMAT_GEMM_PROFILE
+ * environment variable.
+ */
+
+#pragma once
+
+#include "Gemm.hpp"
+#include "Simd.hpp"
+#include <string>
+
+namespace matrix_ops {
+namespace gemm {
+
+/**
+ * @struct TuningProfile
+ * @brief A complete configuration of the engine: cache blocking and micro-kernel
+ *
+ * The micro-kernel (and with it the mr x nr tile shape) is selected by the
+ * instruction set of the double kernels; the other element types always use
+ * the portable kernel and are only affected by the block sizes.
+ */
+struct TuningProfile {
+    BlockSizes blocks;  ///< Cache blocking parameters
+    simd::Isa isa;      ///< Instruction set of the micro-kernel
+};
+
+/**
+ * @brief Environment variable naming the profile file loaded at program startup
+ */
+constexpr const char* PROFILE_VARIABLE = "SQUAREMAT_GEMM_PROFILE";
+
+/**
+ * @brief Get the configuration currently used by the engine
+ *
+ * @return TuningProfile Current block sizes and active instruction set
+ */
+TuningProfile currentProfile();
+
+/**
+ * @brief Force a configuration of the engine
+ *
+ * Not synchronized with running products; configure before multiplying.
+ *
+ * @param profile Configuration to use
+ * @throw std::invalid_argument if a block size is not positive or the CPU does not support profile.isa
+ */
+void applyProfile(const TuningProfile& profile);
+
+/**
+ * @brief Time candidate configurations and apply the fastest
+ *
+ * Each supported instruction set is timed with the current block sizes, then
+ * kc, mc and nc are tuned one after another (coordinate search) for the
+ * winning set. Every candidate is measured as the best of several size x size
+ * double products, using threadCount() threads. Takes a few seconds.
+ *
+ * Only double products are timed; float and integer products run with the
+ * same block sizes. If a timed product throws, the previous configuration is
+ * restored before the exception propagates.
+ *
+ * @param size Size of the timed products
+ * @param repetitions Timed products per candidate
+ * @return TuningProfile The applied configuration
+ * @throw std::invalid_argument if size or repetitions is less than 1
+ */
+TuningProfile autotune(int size = 512, int repetitions = 3);
+
+/**
+ * @brief Write a configuration to a profile file
+ *
+ * @param profile Configuration to save
+ * @param path File to (over)write
+ * @throw std::runtime_error if the file cannot be written
+ */
+void saveProfile(const TuningProfile& profile, const std::string& path);
+
+/**
+ * @brief Read a configuration from a profile file
+ *
+ * The file holds "key = value" lines for isa, mc, kc and nc; blank lines and
+ * lines starting with '#' are ignored. The profile is returned, not applied.
+ *
+ * @param path File to read
+ * @return TuningProfile Configuration from the file
+ * @throw std::runtime_error if the file cannot be read
+ * @throw std::invalid_argument if the file is malformed or incomplete
+ */
+TuningProfile loadProfile(const std::string& path);
+
+/**
+ * @brief Apply the profile named by the SQUAREMAT_GEMM_PROFILE environment variable
+ *
+ * Called automatically once at program startup. A missing variable, an
+ * unreadable or malformed file, or an instruction set this CPU lacks leaves
+ * the configuration unchanged, so a profile copied from another host is harmless.
+ *
+ * @return true if a profile was applied
+ */
+bool loadStartupProfile();
+
+} // namespace gemm
+} // namespace matrix_ops
@@ -0,0 +1,168 @@
+// idocohen963@gmail.com
+/**
+ * @file BufferPool.hpp
+ * @brief Header file for the BufferPool class, a thread-local cache of matrix buffers
+ * 
+ * SquareMat returns element buffers to the pool of the current thread when a
+ * matrix is destroyed, and draws from it when a matrix of the same size is
+ * constructed, so steady-state loops do not touch the system allocator.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace matrix_ops {
+
+/**
+ * @class BufferPool
+ * @brief A thread-local pool of recycled element buffers, grouped by size class
+ * 
+ * Buffers are grouped by their byte size, which is fully determined by the
+ * matrix dimension and element type. Only buffers that come from the global heap
+ * (std::pmr::new_delete_resource) are pooled; matrices built on a custom memory
+ * resource bypass the pool entirely. Since pooled memory belongs to the global
+ * heap, a buffer may be released on a different thread than it was acquired on.
+ */
+class BufferPool {
+public:
+    /**
+     * @struct Stats
+     * @brief Counters describing pool activity since the last reset
+     */
+    struct Stats {
+        std::size_t hits = 0;     ///< Acquisitions served from the pool
+        std::size_t misses = 0;   ///< Acquisitions that fell through to the allocator
+        std::size_t returns = 0;  ///< Releases kept in the pool
+        std::size_t drops = 0;    ///< Releases rejected because a cap was reached
+    };
+
+    static constexpr std::size_t DEFAULT_MAX_BUFFERS_PER_SIZE = 8;        ///< Default per-size-class cap
+    static constexpr std::size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;   ///< Default total cap (64 MiB)
+
+    /**
+     * @brief Get the pool of the calling thread
+     * 
+     * @return BufferPool& The thread-local pool
+     */
+    static BufferPool& local();
+
+    /**
+     * @brief Get the pool of the calling thread if it is still alive
+     * 
+     * During thread (or program) teardown the pool may already be destroyed
+     * while matrices with static or thread storage duration still exist.
+     * 
+     * @return BufferPool* The thread-local pool, or nullptr after it was destroyed
+     */
+    static BufferPool* localIfAlive();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Destructor, frees every cached buffer
+     */
+    ~BufferPool();
+
+    /**
+     * @brief Take a cached buffer of the given size class
+     * 
+     * @param bytes Size of the buffer in bytes
+     * @return void* A cached buffer, or nullptr if none is available (counted as a miss)
+     */
+    void* acquire(std::size_t bytes);
+
+    /**
+     * @brief Offer a buffer back to the pool
+     * 
+     * @param ptr Buffer obtained from std::pmr::new_delete_resource
+     * @param bytes Size of the buffer in bytes
+     * @return bool True if the pool kept the buffer, false if the caller must free it
+     */
+    bool release(void* ptr, std::size_t bytes);
+
+    /**
+     * @brief Free every cached buffer (counters are kept)
+     */
+    void clear();
+
+    /**
+     * @brief Enable or disable pooling on this thread
+     * 
+     * Disabling the pool also frees every cached buffer.
+     * 
+     * @param enabled True to enable pooling
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Set the maximum number of cached buffers per size class
+     * 
+     * @param maxBuffers New cap; excess cached buffers are freed
+     */
+    void setMaxBuffersPerSize(std::size_t maxBuffers);
+
+    /**
+     * @brief Set the maximum total number of cached bytes
+     * 
+     * @param maxBytes New cap; cached buffers are freed until the pool fits
+     */
+    void setMaxBytes(std::size_t maxBytes);
+
+    /**
+     * @brief Check whether pooling is enabled on this thread
+     * 
+     * @return bool True if enabled
+     */
+    bool enabled() const { return isEnabled; }
+
+    /**
+     * @brief Get the number of bytes currently held by the pool
+     * 
+     * @return std::size_t Cached bytes
+     */
+    std::size_t cachedBytes() const { return totalBytes; }
+
+    /**
+     * @brief Get the activity counters
+     * 
+     * @return const Stats& Counters since the last reset
+     */
+    const Stats& stats() const { return counters; }
+
+    /**
+     * @brief Reset the activity counters to zero
+     */
+    void resetStats() { counters = Stats(); }
+
+private:
+    /**
+     * @brief Construct an empty pool (only local() creates pools)
+     */
+    BufferPool();
+
+    std::unordered_map<std::size_t, std::vector<void*>> freeLists;    ///< Cached buffers by byte size
+    std::size_t maxBuffersPerSize = DEFAULT_MAX_BUFFERS_PER_SIZE;     ///< Per-size-class cap
+    std::size_t maxBytes = DEFAULT_MAX_BYTES;                          ///< Total cap in bytes
+    std::size_t totalBytes = 0;                                        ///< Bytes currently cached
+    bool isEnabled = true;                                             ///< Whether pooling is active
+    Stats counters;                                                    ///< Activity counters
+
+    /**
+     * @brief Free cached buffers until both caps are respected
+     */
+    void trim();
+
+    /**
+     * @brief Return a buffer to the global heap
+     * 
+     * @param ptr Buffer to free
+     * @param bytes Size of the buffer in bytes
+     */
+    static void free(void* ptr, std::size_t bytes);
+};
+
+} // namespace matrix_ops
@@ -0,0 +1,347 @@
+// idocohen963@gmail.com
+/**
+ * @file FixedSquareMat.hpp
+ * @brief Header file for the FixedSquareMat class template, a square matrix of compile-time size
+ *
+ * FixedSquareMat<N> stores its N x N elements inline and implements its operators
+ * as constexpr functions over compile-time index sequences, so the compiler can
+ * evaluate them at compile time or fully unroll them at run time. It is meant for
+ * small N (geometry-sized matrices) and converts explicitly to and from the
+ * dynamically sized SquareMat.
+ */
+
+#pragma once
+
+#include "SquareMat.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace matrix_ops {
+
+/**
+ * @class FixedSquareMat
+ * @brief A square matrix whose size N is a template parameter
+ *
+ * @tparam N Size of the square matrix (N x N), must be positive
+ */
+template <int N>
+class FixedSquareMat {
+    static_assert(N > 0, "Matrix size must be positive");
+
+private:
+    double elements[N * N];  ///< Row-major element storage
+
+    /**
+     * @brief Element-wise sum of two matrices, unrolled over all N*N indices
+     */
+    template <std::size_t... I>
+    static constexpr FixedSquareMat add(const FixedSquareMat& a, const FixedSquareMat& b,
+                                        std::index_sequence<I...>) {
+        FixedSquareMat result;
+        ((result.elements[I] = a.elements[I] + b.elements[I]), ...);
+        return result;
+    }
+
+    /**
+     * @brief Element-wise scaling, unrolled over all N*N indices
+     */
+    template <std::size_t... I>
+    static constexpr FixedSquareMat scale(const FixedSquareMat& a, double scalar,
+                                          std::index_sequence<I...>) {
+        FixedSquareMat result;
+        ((result.elements[I] = a.elements[I] * scalar), ...);
+        return result;
+    }
+
+    /**
+     * @brief Dot product of row i of a with column j of b, unrolled over k
+     */
+    template <std::size_t... K>
+    static constexpr double dot(const FixedSquareMat& a, const FixedSquareMat& b,
+                                std::size_t i, std::size_t j, std::index_sequence<K...>) {
+        return ((a.elements[i * N + K] * b.elements[K * N + j]) + ...);
+    }
+
+    /**
+     * @brief Matrix product, unrolled over all N*N output indices
+     */
+    template <std::size_t... I>
+    static constexpr FixedSquareMat multiply(const FixedSquareMat& a, const FixedSquareMat& b,
+                                             std::index_sequence<I...>) {
+        FixedSquareMat result;
+        ((result.elements[I] = dot(a, b, I / N, I % N, std::make_index_sequence<N>{})), ...);
+        return result;
+    }
+
+    /**
+     * @brief Transpose, unrolled over all N*N indices
+     */
+    template <std::size_t... I>
+    static constexpr FixedSquareMat transpose(const FixedSquareMat& a, std::index_sequence<I...>) {
+        FixedSquareMat result;
+        ((result.elements[I] = a.elements[(I % N) * N + I / N]), ...);
+        return result;
+    }
+
+    /**
+     * @brief Check that an index lies in [0, N)
+     *
+     * @param index Index to check
+     * @param message Message of the exception
+     * @throw std::out_of_range if index is out of bounds
+     */
+    static constexpr void checkIndex(int index, const char* message) {
+        if (index < 0 || index >= N) {
+            throw std::out_of_range(message);
+        }
+    }
+
+public:
+    /**
+     * @brief Construct a new Fixed Square Mat object initialized to zeros
+     */
+    constexpr FixedSquareMat() : elements{} {}
+
+    /**
+     * @brief Construct from row-major values; missing trailing values are zero
+     *
+     * @param values Up to N*N elements in row-major order
+     * @throw std::length_error if more than N*N values are given
+     */
+    constexpr FixedSquareMat(std::initializer_list<double> values) : elements{} {
+        if (values.size() > static_cast<std::size_t>(N * N)) {
+            throw std::length_error("Too many values for matrix size");
+        }
+        std::size_t index = 0;
+        for (double value : values) {
+            elements[index++] = value;
+        }
+    }
+
+    /**
+     * @brief Explicit conversion from a dynamically sized matrix
+     *
+     * @param other Matrix to copy, must be N x N
+     * @throw std::invalid_argument if other is not N x N
+     */
+    explicit FixedSquareMat(const SquareMat& other) : elements{} {
+        if (other.dimension() != N) {
+            throw std::invalid_argument("Matrix size does not match fixed size");
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                elements[i * N + j] = other[i][j];
+            }
+        }
+    }
+
+    /**
+     * @brief Explicit conversion to a dynamically sized matrix
+     *
+     * @return SquareMat An N x N copy of this matrix
+     */
+    explicit operator SquareMat() const {
+        SquareMat result(N);
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                result[i][j] = elements[i * N + j];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Create the N x N identity matrix
+     *
+     * @return FixedSquareMat Identity matrix
+     */
+    static constexpr FixedSquareMat identity() {
+        FixedSquareMat result;
+        for (int i = 0; i < N; ++i) {
+            result.elements[i * N + i] = 1.0;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get the size of the matrix
+     *
+     * @return int N
+     */
+    static constexpr int dimension() { return N; }
+
+    /**
+     * @brief Access element at the given position with bounds checking
+     *
+     * @param row Row index
+     * @param col Column index
+     * @return double& Reference to the element
+     * @throw std::out_of_range if an index is out of bounds
+     */
+    constexpr double& operator()(int row, int col) {
+        checkIndex(row, "Row index out of range");
+        checkIndex(col, "Column index out of range");
+        return elements[row * N + col];
+    }
+
+    /**
+     * @brief Access element at the given position with bounds checking (const version)
+     *
+     * @param row Row index
+     * @param col Column index
+     * @return const double& Const reference to the element
+     * @throw std::out_of_range if an index is out of bounds
+     */
+    constexpr const double& operator()(int row, int col) const {
+        checkIndex(row, "Row index out of range");
+        checkIndex(col, "Column index out of range");
+        return elements[row * N + col];
+    }
+
+    /**
+     * @brief Add two matrices
+     *
+     * @param other Matrix to add
+     * @return FixedSquareMat Result of addition
+     */
+    constexpr FixedSquareMat operator+(const FixedSquareMat& other) const {
+        return add(*this, other, std::make_index_sequence<N * N>{});
+    }
+
+    /**
+     * @brief Multiply two matrices
+     *
+     * @param other Matrix to multiply with
+     * @return FixedSquareMat Result of multiplication
+     */
+    constexpr FixedSquareMat operator*(const FixedSquareMat& other) const {
+        return multiply(*this, other, std::make_index_sequence<N * N>{});
+    }
+
+    /**
+     * @brief Multiply matrix by scalar
+     *
+     * @param scalar Scalar value
+     * @return FixedSquareMat Result of multiplication
+     */
+    constexpr FixedSquareMat operator*(double scalar) const {
+        return scale(*this, scalar, std::make_index_sequence<N * N>{});
+    }
+
+    /**
+     * @brief Transpose the matrix
+     *
+     * @return FixedSquareMat Transposed matrix
+     */
+    constexpr FixedSquareMat operator~() const {
+        return transpose(*this, std::make_index_sequence<N * N>{});
+    }
+
+    /**
+     * @brief Calculate determinant of the matrix
+     *
+     * Uses Gaussian elimination with partial pivoting, O(N^3).
+     *
+     * @return double Determinant value
+     */
+    constexpr double operator!() const {
+        double work[N * N] = {};
+        for (int i = 0; i < N * N; ++i) {
+            work[i] = elements[i];
+        }
+        double det = 1.0;
+        for (int col = 0; col < N; ++col) {
+            // Choose the largest pivot in this column for stability
+            int pivot = col;
+            for (int row = col + 1; row < N; ++row) {
+                double candidate = work[row * N + col] < 0 ? -work[row * N + col] : work[row * N + col];
+                double best = work[pivot * N + col] < 0 ? -work[pivot * N + col] : work[pivot * N + col];
+                if (candidate > best) {
+                    pivot = row;
+                }
+            }
+            if (work[pivot * N + col] == 0.0) {
+                return 0.0;
+            }
+            if (pivot != col) {
+                for (int j = 0; j < N; ++j) {
+                    double tmp = work[col * N + j];
+                    work[col * N + j] = work[pivot * N + j];
+                    work[pivot * N + j] = tmp;
+                }
+                det = -det;
+            }
+            det *= work[col * N + col];
+            for (int row = col + 1; row < N; ++row) {
+                double factor = work[row * N + col] / work[col * N + col];
+                for (int j = col; j < N; ++j) {
+                    work[row * N + j] -= factor * work[col * N + j];
+                }
+            }
+        }
+        return det;
+    }
+
+    /**
+     * @brief Raise matrix to a non-negative integer power
+     *
+     * Uses binary exponentiation, O(log power) products. Negative powers are
+     * deliberately left to BasicSquareMat, whose inverse() handles singular and
+     * badly scaled matrices; convert to SquareMat to raise to one.
+     *
+     * @param power Power to raise to (must be >= 0)
+     * @return FixedSquareMat Result of power operation
+     * @throw std::invalid_argument if power is negative
+     */
+    constexpr FixedSquareMat operator^(int power) const {
+        if (power < 0) {
+            throw std::invalid_argument("FixedSquareMat supports only non-negative powers; use SquareMat");
+        }
+        FixedSquareMat result = identity();
+        FixedSquareMat base = *this;
+        while (power > 0) {
+            if (power & 1) {
+                result = result * base;
+            }
+            power >>= 1;
+            if (power > 0) {
+                base = base * base;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Friend function for scalar * matrix multiplication
+     *
+     * @param scalar Scalar value
+     * @param mat Matrix to multiply
+     * @return FixedSquareMat Result of multiplication
+     */
+    friend constexpr FixedSquareMat operator*(double scalar, const FixedSquareMat& mat) {
+        return mat * scalar;
+    }
+
+    /**
+     * @brief Friend function for matrix output
+     *
+     * @param os Output stream
+     * @param mat Matrix to output
+     * @return std::ostream& Reference to output stream
+     */
+    friend std::ostream& operator<<(std::ostream& os, const FixedSquareMat& mat) {
+        for (int i = 0; i < N; ++i) {
+            os << "| " << " ";
+            for (int j = 0; j < N; ++j) {
+                os << mat.elements[i * N + j] << " ";
+            }
+            os << " |" << std::endl;
+        }
+        return os;
+    }
+};
+
+} // namespace matrix_ops
@@ -0,0 +1,207 @@
+// idocohen963@gmail.com
+/**
+ * @file Gemm.hpp
+ * @brief Header file for the blocked matrix multiplication engine behind SquareMat::operator*
+ *
+ * The engine computes C = alpha * A * B + beta * C for square row-major operands
+ * with arbitrary leading dimensions. Large products are split into cache-sized
+ * blocks; panels of A and B are packed into contiguous buffers and a
+ * register-blocked micro-kernel computes one mr x nr tile of C at a time. For
+ * double, the micro-kernel and its tile shape come from the runtime-dispatched
+ * SIMD kernels (see Simd.hpp); the other element types use a portable 4 x 8 kernel.
+ * Large products are split into row and column blocks of C that run in parallel
+ * on the shared ThreadPool.
+ */
+
+#pragma once
+
+namespace matrix_ops {
+namespace gemm {
+
+/**
+ * @struct BlockSizes
+ * @brief Cache blocking parameters of the engine
+ *
+ * kc x nr panels of B should stay in L1, mc x kc blocks of A in L2 and
+ * kc x nc panels of B in L3.
+ */
+struct BlockSizes {
+    int mc;  ///< Rows of A packed per block
+    int kc;  ///< Depth of the packed panels
+    int nc;  ///< Columns of B packed per block
+};
+
+/**
+ * @brief Default block sizes, suitable for common x86 cache hierarchies
+ */
+constexpr BlockSizes DEFAULT_BLOCK_SIZES = {128, 256, 2048};
+
+/**
+ * @brief Products up to this size skip packing and use a direct loop
+ */
+constexpr int SMALL_PRODUCT_LIMIT = 32;
+
+/**
+ * @brief Products smaller than this size always run on the calling thread
+ */
+constexpr int PARALLEL_PRODUCT_LIMIT = 128;
+
+/**
+ * @brief Get the block sizes currently used by the engine
+ *
+ * @return BlockSizes Current blocking parameters
+ */
+BlockSizes blockSizes();
+
+/**
+ * @brief Set the block sizes used by the engine
+ *
+ * Safe to call while products run; a product already in progress keeps the
+ * sizes it started with.
+ *
+ * @param sizes New blocking parameters (all must be positive)
+ * @throw std::invalid_argument if a block size is not positive
+ */
+void setBlockSizes(BlockSizes sizes);
+
+/**
+ * @brief Get the process-wide number of threads used by large products
+ *
+ * @return int Thread count (defaults to the number of hardware threads)
+ */
+int threadCount();
+
+/**
+ * @brief Set the process-wide number of threads used by large products
+ *
+ * @param threads Number of threads, including the calling one (1 disables parallelism)
+ * @throw std::invalid_argument if threads is less than 1
+ */
+void setThreadCount(int threads);
+
+/**
+ * @enum Algorithm
+ * @brief Multiplication algorithm used by SquareMat products
+ */
+enum class Algorithm {
+    Classical,         ///< Blocked O(n^3) product (default)
+    StrassenWinograd   ///< Strassen-Winograd recursion above the crossover size
+};
+
+/**
+ * @brief Default size at or below which the Strassen-Winograd recursion switches to the classical kernel
+ */
+constexpr int DEFAULT_STRASSEN_CROSSOVER = 1024;
+
+/**
+ * @brief Get the algorithm used by SquareMat products
+ *
+ * @return Algorithm Current algorithm
+ */
+Algorithm algorithm();
+
+/**
+ * @brief Select the algorithm used by SquareMat products
+ *
+ * Strassen-Winograd is opt-in because it trades accuracy for speed; see
+ * multiplyStrassen() for the error bound.
+ *
+ * @param algorithm Algorithm to use
+ */
+void setAlgorithm(Algorithm algorithm);
+
+/**
+ * @brief Get the crossover size of the Strassen-Winograd recursion
+ *
+ * @return int Largest size multiplied with the classical kernel
+ */
+int strassenCrossover();
+
+/**
+ * @brief Set the crossover size of the Strassen-Winograd recursion
+ *
+ * @param size Largest size multiplied with the classical kernel
+ * @throw std::invalid_argument if size is less than 1
+ */
+void setStrassenCrossover(int size);
+
+/**
+ * @brief Compute C = A * B with the Strassen-Winograd recursion
+ *
+ * Each level splits the even part of the operands into 2 x 2 blocks and forms
+ * the product with 7 half-size multiplications and 15 block additions. An odd
+ * size is handled by peeling: the last row and column are computed directly
+ * and added as rank-1 and matrix-vector updates. Sizes at or below
+ * strassenCrossover() use the classical kernel. All temporaries live in a
+ * per-thread workspace of about 2n^2/3 elements that is sized once per call,
+ * so the recursion does not allocate.
+ *
+ * Error bound: the classical product satisfies the componentwise bound
+ * |C - fl(C)| <= n u |A| |B| (u is the unit roundoff). Strassen-Winograd only
+ * satisfies a normwise bound, roughly
+ * max|C - fl(C)| <= ((n / n0)^log2(18) (n0^2 + 6 n0) - 6n) u max|A| max|B|
+ * for crossover n0 (Higham, Accuracy and Stability of Numerical Algorithms,
+ * section 23.2). Elements of C that are much smaller than |A| |B| may lose
+ * all relative accuracy, and each extra level multiplies the bound by about 18.
+ * For integer types the result is exact, but intermediate sums reach about 4x
+ * the magnitude of the classical ones, so overflow happens sooner.
+ *
+ * @tparam T Element type (float, double, std::int32_t or std::int64_t)
+ * @param n Size of the matrices
+ * @param a Pointer to A(0, 0)
+ * @param lda Leading dimension of A
+ * @param b Pointer to B(0, 0)
+ * @param ldb Leading dimension of B
+ * @param c Pointer to C(0, 0), not read
+ * @param ldc Leading dimension of C
+ * @param threads Number of threads for the classical products (0 for threadCount())
+ */
+template <typename T>
+void multiplyStrassen(int n, const T* a, int lda, const T* b, int ldb, T* c, int ldc, int threads = 0);
+
+/**
+ * @brief Compute C = alpha * A * B + beta * C for n x n row-major matrices
+ *
+ * When beta is zero, C is not read, so it may hold uninitialized values.
+ * C must not overlap A or B.
+ *
+ * @tparam T Element type (float, double, std::int32_t or std::int64_t)
+ * @param n Size of the matrices
+ * @param alpha Scale of the product
+ * @param a Pointer to A(0, 0)
+ * @param lda Leading dimension of A
+ * @param b Pointer to B(0, 0)
+ * @param ldb Leading dimension of B
+ * @param beta Scale of the existing C
+ * @param c Pointer to C(0, 0)
+ * @param ldc Leading dimension of C
+ * @param threads Number of threads to use (0 for threadCount()); ignored below PARALLEL_PRODUCT_LIMIT
+ */
+template <typename T>
+void multiply(int n, T alpha, const T* a, int lda, const T* b, int ldb, T beta, T* c, int ldc, int threads = 0);
+
+/**
+ * @brief Compute the symmetric product C = alpha * A * A^T + beta * C for an n x n row-major A
+ *
+ * Works like multiply() with B = A^T, but the panels of A^T are packed straight
+ * from the rows of A (no transpose is formed) and only the micro-tiles that
+ * touch the lower triangle of C are computed, about half the flops of the
+ * general product. The strict lower triangle is then mirrored onto the upper
+ * one. When beta is nonzero only the lower triangle of C is read, so C must
+ * be symmetric for the result to equal the general formula. C must not overlap A.
+ *
+ * @tparam T Element type (float, double, std::int32_t or std::int64_t)
+ * @param n Size of the matrices
+ * @param alpha Scale of the product
+ * @param a Pointer to A(0, 0)
+ * @param lda Leading dimension of A
+ * @param beta Scale of the existing C
+ * @param c Pointer to C(0, 0)
+ * @param ldc Leading dimension of C
+ * @param threads Number of threads to use (0 for threadCount()); ignored below PARALLEL_PRODUCT_LIMIT
+ */
+template <typename T>
+void gram(int n, T alpha, const T* a, int lda, T beta, T* c, int ldc, int threads = 0);
+
+} // namespace gemm
+} // namespace matrix_ops
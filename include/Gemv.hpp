@@ -0,0 +1,91 @@
+// idocohen963@gmail.com
+/**
+ * @file Gemv.hpp
+ * @brief Header file for the matrix-vector and vector kernels behind BasicVector
+ *
+ * Matrix-vector products read every element of the matrix exactly once, so
+ * they are limited by memory bandwidth rather than arithmetic. The kernels
+ * stream the matrix row by row, four rows at a time, keeping the vector
+ * operands in cache, and split large problems across the shared ThreadPool
+ * (using gemm::threadCount() threads unless told otherwise).
+ */
+
+#pragma once
+
+namespace matrix_ops {
+namespace gemv {
+
+/**
+ * @brief Matrix-vector products smaller than this size always run on the calling thread
+ */
+constexpr int PARALLEL_PRODUCT_LIMIT = 256;
+
+/**
+ * @brief Vector operations shorter than this length always run on the calling thread
+ */
+constexpr int PARALLEL_LENGTH_LIMIT = 1 << 16;
+
+/**
+ * @brief Compute y = alpha * A * x + beta * y for an n x n row-major matrix
+ *
+ * When beta is zero, y is not read. y must not overlap A or x.
+ *
+ * @tparam T Element type (float, double, std::int32_t or std::int64_t)
+ * @param n Size of the matrix and vectors
+ * @param alpha Scale of the product
+ * @param a Pointer to A(0, 0)
+ * @param lda Leading dimension of A
+ * @param x Pointer to the input vector
+ * @param beta Scale of the existing y
+ * @param y Pointer to the output vector
+ * @param threads Number of threads to use (0 for gemm::threadCount()); ignored below PARALLEL_PRODUCT_LIMIT
+ */
+template <typename T>
+void multiply(int n, T alpha, const T* a, int lda, const T* x, T beta, T* y, int threads = 0);
+
+/**
+ * @brief Compute y = alpha * x * A + beta * y (the row vector x times A, i.e. A^T x)
+ *
+ * When beta is zero, y is not read. y must not overlap A or x.
+ *
+ * @tparam T Element type (float, double, std::int32_t or std::int64_t)
+ * @param n Size of the matrix and vectors
+ * @param alpha Scale of the product
+ * @param a Pointer to A(0, 0)
+ * @param lda Leading dimension of A
+ * @param x Pointer to the input vector
+ * @param beta Scale of the existing y
+ * @param y Pointer to the output vector
+ * @param threads Number of threads to use (0 for gemm::threadCount()); ignored below PARALLEL_PRODUCT_LIMIT
+ */
+template <typename T>
+void multiplyTransposed(int n, T alpha, const T* a, int lda, const T* x, T beta, T* y, int threads = 0);
+
+/**
+ * @brief Compute the dot product of two vectors
+ *
+ * @tparam T Element type
+ * @param n Length of the vectors
+ * @param x Pointer to the first vector
+ * @param y Pointer to the second vector
+ * @param threads Number of threads to use (0 for gemm::threadCount()); ignored below PARALLEL_LENGTH_LIMIT
+ * @return T Sum of x[i] * y[i]
+ */
+template <typename T>
+T dot(int n, const T* x, const T* y, int threads = 0);
+
+/**
+ * @brief Compute y = alpha * x + y
+ *
+ * @tparam T Element type
+ * @param n Length of the vectors
+ * @param alpha Scale of x
+ * @param x Pointer to the input vector
+ * @param y Pointer to the vector updated in place
+ * @param threads Number of threads to use (0 for gemm::threadCount()); ignored below PARALLEL_LENGTH_LIMIT
+ */
+template <typename T>
+void axpy(int n, T alpha, const T* x, T* y, int threads = 0);
+
+} // namespace gemv
+} // namespace matrix_ops
@@ -0,0 +1,247 @@
+// idocohen963@gmail.com
+/**
+ * @file MatrixView.hpp
+ * @brief Header file for the MatrixView class template, a non-owning view of a square block
+ *
+ * A MatrixView refers to an n x n region of row-major elements with an arbitrary
+ * row stride. It can wrap a whole BasicSquareMat, a sub-block of one, or any
+ * external buffer, and is accepted by the read-only matrix operations without
+ * copying the elements. A MinorView is the (n-1) x (n-1) minor of a view with
+ * one row and one column skipped.
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace matrix_ops {
+
+template <typename T>
+class MinorView;
+
+/**
+ * @class MatrixView
+ * @brief A lightweight, non-owning view of a strided square block of elements
+ *
+ * The view never allocates or frees memory; the viewed buffer must outlive it.
+ * Use MatrixView<const T> for read-only access.
+ *
+ * @tparam T Element type, possibly const-qualified
+ */
+template <typename T>
+class MatrixView {
+private:
+    T* origin;   ///< Pointer to element (0, 0) of the block
+    int size;    ///< Size of the square block (n x n)
+    int stride;  ///< Distance (in elements) between the starts of consecutive rows
+
+public:
+    /**
+     * @brief Construct a view over an external row-major buffer
+     *
+     * @param data Pointer to element (0, 0)
+     * @param size Size of the square block
+     * @param stride Distance in elements between consecutive rows (at least size)
+     * @throw std::length_error if size is less than or equal to 0
+     * @throw std::invalid_argument if data is null or stride is less than size
+     */
+    MatrixView(T* data, int size, int stride) : origin(data), size(size), stride(stride) {
+        if (size <= 0) {
+            throw std::length_error("Matrix size must be positive");
+        }
+        if (data == nullptr || stride < size) {
+            throw std::invalid_argument("Invalid buffer for matrix view");
+        }
+    }
+
+    /**
+     * @brief Construct a view over a densely packed buffer (stride equals size)
+     *
+     * @param data Pointer to element (0, 0)
+     * @param size Size of the square block
+     * @throw std::length_error if size is less than or equal to 0
+     * @throw std::invalid_argument if data is null
+     */
+    MatrixView(T* data, int size) : MatrixView(data, size, size) {}
+
+    /**
+     * @brief Implicit conversion from a mutable view to a read-only view
+     *
+     * @return MatrixView<const T> Read-only view of the same block
+     */
+    template <typename U = T, typename = std::enable_if_t<!std::is_const<U>::value>>
+    operator MatrixView<const U>() const {
+        return MatrixView<const U>(origin, size, stride);
+    }
+
+    /**
+     * @brief Get the size of the viewed block
+     *
+     * @return int Number of rows (and columns)
+     */
+    int dimension() const { return size; }
+
+    /**
+     * @brief Get the leading dimension (row stride) of the viewed buffer
+     *
+     * @return int Distance in elements between the starts of consecutive rows
+     */
+    int leadingDimension() const { return stride; }
+
+    /**
+     * @brief Get a pointer to element (0, 0)
+     *
+     * @return T* Pointer to the first element of the block
+     */
+    T* data() const { return origin; }
+
+    /**
+     * @brief Get a pointer to the first element of a row (unchecked)
+     *
+     * @param row Row index
+     * @return T* Pointer to element (row, 0)
+     */
+    T* row(int row) const { return origin + row * stride; }
+
+    /**
+     * @brief Access element at the given position with bounds checking
+     *
+     * @param row Row index
+     * @param col Column index
+     * @return T& Reference to the element
+     * @throw std::out_of_range if an index is out of bounds
+     */
+    T& operator()(int row, int col) const {
+        if (row < 0 || row >= size) {
+            throw std::out_of_range("Row index out of range");
+        }
+        if (col < 0 || col >= size) {
+            throw std::out_of_range("Column index out of range");
+        }
+        return origin[row * stride + col];
+    }
+
+    /**
+     * @brief Get a view of an n x n sub-block
+     *
+     * @param row Row of the block's top-left element
+     * @param col Column of the block's top-left element
+     * @param n Size of the block
+     * @return MatrixView View of the sub-block, sharing this view's buffer
+     * @throw std::out_of_range if the block does not fit inside this view
+     */
+    MatrixView block(int row, int col, int n) const {
+        if (n <= 0 || row < 0 || col < 0 || row + n > size || col + n > size) {
+            throw std::out_of_range("Block out of range");
+        }
+        return MatrixView(origin + row * stride + col, n, stride);
+    }
+
+    /**
+     * @brief Get a view of the minor with one row and one column skipped
+     *
+     * @param row Row to skip
+     * @param col Column to skip
+     * @return MinorView<T> View of the (n-1) x (n-1) minor, sharing this view's buffer
+     * @throw std::out_of_range if an index is out of bounds
+     * @throw std::length_error if this view is 1 x 1 (the minor would be empty)
+     */
+    MinorView<T> minor(int row, int col) const {
+        return MinorView<T>(*this, row, col);
+    }
+};
+
+/**
+ * @class MinorView
+ * @brief A non-owning view of a MatrixView with one row and one column skipped
+ *
+ * Rows and columns past the skipped ones are shifted up and left by one. Like
+ * MatrixView, it never copies or owns the elements.
+ *
+ * @tparam T Element type, possibly const-qualified
+ */
+template <typename T>
+class MinorView {
+private:
+    MatrixView<T> source;  ///< The full view
+    int skipRow;           ///< Row of source left out of the minor
+    int skipCol;           ///< Column of source left out of the minor
+
+public:
+    /**
+     * @brief Construct the minor of a view
+     *
+     * @param source View of the full matrix
+     * @param row Row to skip
+     * @param col Column to skip
+     * @throw std::out_of_range if an index is out of bounds
+     * @throw std::length_error if source is 1 x 1 (the minor would be empty)
+     */
+    MinorView(MatrixView<T> source, int row, int col) : source(source), skipRow(row), skipCol(col) {
+        if (row < 0 || row >= source.dimension() || col < 0 || col >= source.dimension()) {
+            throw std::out_of_range("Minor index out of range");
+        }
+        if (source.dimension() == 1) {
+            throw std::length_error("Minor of a 1 x 1 matrix is empty");
+        }
+    }
+
+    /**
+     * @brief Implicit conversion from a mutable minor to a read-only minor
+     *
+     * @return MinorView<const T> Read-only view of the same minor
+     */
+    template <typename U = T, typename = std::enable_if_t<!std::is_const<U>::value>>
+    operator MinorView<const U>() const {
+        return MinorView<const U>(source, skipRow, skipCol);
+    }
+
+    /**
+     * @brief Get the size of the minor
+     *
+     * @return int Number of rows (and columns), one less than the source
+     */
+    int dimension() const { return source.dimension() - 1; }
+
+    /**
+     * @brief Get the full view the minor is taken from
+     *
+     * @return MatrixView<T> The source view
+     */
+    MatrixView<T> parent() const { return source; }
+
+    /**
+     * @brief Get the skipped row of the source
+     *
+     * @return int Row index in the source
+     */
+    int skippedRow() const { return skipRow; }
+
+    /**
+     * @brief Get the skipped column of the source
+     *
+     * @return int Column index in the source
+     */
+    int skippedColumn() const { return skipCol; }
+
+    /**
+     * @brief Access element at the given position of the minor with bounds checking
+     *
+     * @param row Row index in the minor
+     * @param col Column index in the minor
+     * @return T& Reference to the element
+     * @throw std::out_of_range if an index is out of bounds
+     */
+    T& operator()(int row, int col) const {
+        if (row < 0 || row >= dimension()) {
+            throw std::out_of_range("Row index out of range");
+        }
+        if (col < 0 || col >= dimension()) {
+            throw std::out_of_range("Column index out of range");
+        }
+        return source.row(row + (row >= skipRow))[col + (col >= skipCol)];
+    }
+};
+
+} // namespace matrix_ops
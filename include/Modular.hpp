@@ -0,0 +1,58 @@
+// idocohen963@gmail.com
+/**
+ * @file Modular.hpp
+ * @brief Header file for exact matrix products and powers over the integers modulo m
+ *
+ * (A ^ p) % m overflows long before the modulo is applied, and double elements
+ * lose exactness beyond 2^53. These functions keep every element reduced to
+ * [0, m) after each product instead. Products accumulate 64 x 64 -> 128-bit
+ * (or, for m <= 2^32, 32 x 32 -> 64-bit) terms lazily and reduce them with
+ * Barrett reduction only when the accumulator could overflow. For the common
+ * 32-bit moduli that is once every few dozen terms, and the inner loop is the
+ * widening integer multiply-add kernel of the active SIMD instruction set.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "SquareMat.hpp"
+
+namespace matrix_ops {
+
+/**
+ * @brief Multiply two matrices modulo m
+ *
+ * Elements of the operands may be negative or exceed m; they are reduced
+ * first. Every element of the result lies in [0, m), so m - 1 must fit in T.
+ *
+ * @tparam T Element type (std::int32_t or std::int64_t)
+ * @param a Left operand
+ * @param b Right operand
+ * @param modulus The modulus m
+ * @param threads Number of threads to use (0 for gemm::threadCount())
+ * @return BasicSquareMat<T> (a * b) mod m
+ * @throw std::invalid_argument if sizes differ, modulus is not positive, residues do not fit in T,
+ *        or threads is negative
+ */
+template <typename T>
+BasicSquareMat<T> multiplyMod(const BasicSquareMat<T>& a, const BasicSquareMat<T>& b, std::int64_t modulus,
+                              int threads = 0);
+
+/**
+ * @brief Raise a matrix to a power modulo m, exactly
+ *
+ * Binary exponentiation over a 64-bit exponent, reducing after every product,
+ * so p up to 2^64 - 1 costs at most 128 modular products.
+ *
+ * @tparam T Element type (std::int32_t or std::int64_t)
+ * @param a Base matrix
+ * @param power Exponent
+ * @param modulus The modulus m
+ * @param threads Number of threads to use (0 for gemm::threadCount())
+ * @return BasicSquareMat<T> (a ^ power) mod m, elements in [0, m)
+ * @throw std::invalid_argument if modulus is not positive, residues do not fit in T or threads is negative
+ */
+template <typename T>
+BasicSquareMat<T> powmod(const BasicSquareMat<T>& a, std::uint64_t power, std::int64_t modulus, int threads = 0);
+
+} // namespace matrix_ops
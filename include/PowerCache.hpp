@@ -0,0 +1,157 @@
+// idocohen963@gmail.com
+/**
+ * @file PowerCache.hpp
+ * @brief Header file for the BasicPowerCache class template, a cached ladder of squarings
+ *
+ * Answering A^k for many k against the same A with operator^ repeats the same
+ * squarings A^2, A^4, A^8, ... for every query. A power cache keeps those
+ * squarings (the "ladder" A^(2^i)) and forms each requested power from the
+ * rungs selected by the bits of the exponent, so a query costs one product per
+ * set bit once the ladder is warm.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "SquareMat.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace matrix_ops {
+
+/**
+ * @class BasicPowerCache
+ * @brief Answers powers of one base matrix from cached squarings A^(2^i)
+ *
+ * Rungs are computed on demand by squaring up from the highest cached lower
+ * rung, and kept while they fit in the memory capacity; beyond it the least
+ * recently used rung is evicted. The cache refers to the base matrix, which
+ * must outlive it, and keeps a copy of the elements the rungs were computed
+ * from (not counted against the capacity). Every query compares the base with
+ * that copy, an O(n^2) check, and drops every rung if any element changed,
+ * whether through an operator, a view or a row proxy. A cache is not safe for
+ * concurrent use.
+ *
+ * @tparam T Element type; instantiated for float, double, std::int32_t and std::int64_t
+ */
+template <typename T>
+class BasicPowerCache {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = std::size_t(64) << 20;  ///< Default memory cap in bytes
+
+private:
+    using Rung = std::shared_ptr<const BasicSquareMat<T>>;
+
+    const BasicSquareMat<T>& base;      ///< Matrix whose powers are cached
+    BasicSquareMat<T> snapshot;         ///< Copy of base the rungs were computed from
+    std::size_t capacity;               ///< Memory cap for the cached rungs, in bytes
+    std::size_t used;                   ///< Bytes held by the cached rungs
+    std::uint64_t clock;                ///< Use counter for the LRU policy
+    std::vector<Rung> ladder;           ///< ladder[i] = base^(2^i), or nullptr if not cached (index 0 unused)
+    std::vector<std::uint64_t> lastUse; ///< Value of clock when ladder[i] was last used
+
+    /**
+     * @brief Get the memory held by one cached matrix
+     *
+     * @param mat Matrix
+     * @return std::size_t Bytes of the object and its element buffer
+     */
+    static std::size_t footprint(const BasicSquareMat<T>& mat);
+
+    /**
+     * @brief Drop every rung if the base no longer matches the snapshot they were computed from
+     */
+    void refresh();
+
+    /**
+     * @brief Remove the least recently used rung
+     */
+    void evictOne();
+
+    /**
+     * @brief Cache a rung if it fits, evicting older rungs as needed
+     *
+     * @param level Exponent bit of the rung
+     * @param rung base^(2^level)
+     */
+    void store(int level, const Rung& rung);
+
+    /**
+     * @brief Get base^(2^level), squaring up from the highest cached lower rung
+     *
+     * @param level Exponent bit
+     * @return Rung The rung; stays valid even if it is evicted later
+     */
+    Rung rung(int level);
+
+public:
+    /**
+     * @brief Construct an empty cache for powers of base
+     *
+     * @param base Matrix whose powers are requested; must outlive the cache
+     * @param capacity Memory cap for cached rungs, in bytes
+     */
+    explicit BasicPowerCache(const BasicSquareMat<T>& base, std::size_t capacity = DEFAULT_CAPACITY);
+
+    BasicPowerCache(const BasicPowerCache&) = delete;
+    BasicPowerCache& operator=(const BasicPowerCache&) = delete;
+
+    /**
+     * @brief Compute base^exponent from cached squarings
+     *
+     * Equals base ^ exponent. Rungs needed on the way are cached for later queries.
+     *
+     * @param exponent Power to raise to (must be >= 0)
+     * @return BasicSquareMat<T> The power
+     * @throw std::invalid_argument if exponent is negative
+     * @throw std::length_error if base is empty (moved-from)
+     */
+    BasicSquareMat<T> power(int exponent);
+
+    /**
+     * @brief Get the number of cached rungs
+     *
+     * @return int Cached squarings, not counting the base itself
+     */
+    int cachedRungs() const;
+
+    /**
+     * @brief Get the memory held by the cached rungs
+     *
+     * @return std::size_t Bytes in use, at most memoryCapacity()
+     */
+    std::size_t memoryUsage() const { return used; }
+
+    /**
+     * @brief Get the memory cap
+     *
+     * @return std::size_t Capacity in bytes
+     */
+    std::size_t memoryCapacity() const { return capacity; }
+
+    /**
+     * @brief Change the memory cap, evicting rungs until the cache fits
+     *
+     * @param bytes New capacity in bytes (0 disables caching)
+     */
+    void setMemoryCapacity(std::size_t bytes);
+
+    /**
+     * @brief Drop every cached rung
+     */
+    void clear();
+};
+
+extern template class BasicPowerCache<float>;
+extern template class BasicPowerCache<double>;
+extern template class BasicPowerCache<std::int32_t>;
+extern template class BasicPowerCache<std::int64_t>;
+
+using PowerCache = BasicPowerCache<double>;           ///< Power cache for double-precision matrices
+using PowerCacheF = BasicPowerCache<float>;           ///< Power cache for single-precision matrices
+using PowerCacheI32 = BasicPowerCache<std::int32_t>;  ///< Power cache for 32-bit integer matrices
+using PowerCacheI64 = BasicPowerCache<std::int64_t>;  ///< Power cache for 64-bit integer matrices
+
+} // namespace matrix_ops
@@ -0,0 +1,93 @@
+// idocohen963@gmail.com
+/**
+ * @file Simd.hpp
+ * @brief Header file for the runtime-dispatched SIMD kernels used by double matrices and modular products
+ *
+ * The library is built for a baseline x86-64 target, and the vector kernels are
+ * compiled per instruction set with function-level target attributes. The best
+ * set supported by the running CPU is picked once, on first use, from cpuid;
+ * a portable scalar implementation is always available.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace matrix_ops {
+namespace simd {
+
+/**
+ * @enum Isa
+ * @brief Instruction sets with a dedicated kernel implementation, in increasing order
+ */
+enum class Isa {
+    Scalar,  ///< Portable C++ loops
+    SSE2,    ///< 128-bit vectors
+    AVX2,    ///< 256-bit vectors with fused multiply-add
+    AVX512   ///< 512-bit vectors (AVX-512F)
+};
+
+/**
+ * @struct Kernels
+ * @brief Table of kernels implemented for one instruction set
+ *
+ * Elementwise kernels process n contiguous elements and allow r to alias a or b.
+ * The GEMM micro-kernel computes an mr x nr tile C = alpha * A * B + beta * C from
+ * packed panels (A: mr values per k, B: nr values per k), without reading C when
+ * beta is zero.
+ */
+struct Kernels {
+    Isa isa;  ///< Instruction set of this table
+    int mr;   ///< Rows of the GEMM micro-kernel tile
+    int nr;   ///< Columns of the GEMM micro-kernel tile
+    void (*gemm)(int kc, const double* a, const double* b, double* c, int ldc, double alpha, double beta);
+    void (*add)(const double* a, const double* b, double* r, int n);       ///< r = a + b
+    void (*subtract)(const double* a, const double* b, double* r, int n);  ///< r = a - b
+    void (*multiply)(const double* a, const double* b, double* r, int n);  ///< r = a * b
+    void (*scale)(const double* a, double scalar, double* r, int n);       ///< r = a * scalar
+    void (*divide)(const double* a, double scalar, double* r, int n);      ///< r = a / scalar
+    /// acc += scalar * b on unsigned integers, scalar < 2^32 (widening 32 x 32 -> 64-bit products)
+    void (*multiplyAddWide)(std::uint64_t scalar, const std::uint32_t* b, std::uint64_t* acc, int n);
+};
+
+/**
+ * @brief Get the best instruction set supported by this CPU
+ *
+ * @return Isa Detected instruction set
+ */
+Isa detectedIsa();
+
+/**
+ * @brief Get the instruction set whose kernels are currently in use
+ *
+ * @return Isa Active instruction set (detectedIsa() unless overridden)
+ */
+Isa activeIsa();
+
+/**
+ * @brief Force the kernels of a specific instruction set
+ *
+ * Intended for testing and benchmarking.
+ *
+ * @param isa Instruction set to use
+ * @throw std::invalid_argument if the CPU does not support isa
+ */
+void setActiveIsa(Isa isa);
+
+/**
+ * @brief Get a printable name of an instruction set
+ *
+ * @param isa Instruction set
+ * @return const char* Name such as "AVX2"
+ */
+const char* isaName(Isa isa);
+
+/**
+ * @brief Get the kernel table of the active instruction set
+ *
+ * @return const Kernels& Active kernels
+ */
+const Kernels& kernels();
+
+} // namespace simd
+} // namespace matrix_ops
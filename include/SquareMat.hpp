@@ -1,28 +1,62 @@
 // idocohen963@gmail.com
 /**
  * @file SquareMat.hpp
- * @brief Header file for the SquareMat class, implementing square matrix operations
+ * @brief Header file for the BasicSquareMat class template, implementing square matrix operations
  * 
- * This file contains the declaration of the SquareMat class which implements
+ * This file contains the declaration of the BasicSquareMat class template which implements
  * various operations on square matrices including arithmetic operations,
  * matrix-specific operations like transpose and determinant, and comparison operations.
+ * SquareMat is the double-precision instantiation; float, int32 and int64 elements
+ * are also provided.
  */
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory_resource>
+#include "MatrixView.hpp"
 #include <stdexcept>
+#include <utility>
+#include <vector>
 namespace matrix_ops {
 
 /**
- * @class SquareMat
- * @brief A class representing a square matrix with various operations
+ * @enum PowerStrategy
+ * @brief How BasicSquareMat::power evaluates A^p
+ */
+enum class PowerStrategy {
+    Automatic,       ///< Pick the strategy with fewer matrix products for this size and exponent
+    Squaring,        ///< Binary exponentiation, about 1.5 log2(p) products
+    CayleyHamilton   ///< Reduce x^p modulo the characteristic polynomial, then evaluate it at A: about 2n products
+};
+
+/**
+ * @class BasicSquareMat
+ * @brief A class template representing a square matrix with various operations
+ * 
+ * This class implements a square matrix stored in a single contiguous,
+ * cache-line aligned row-major buffer with a padded leading dimension and provides various operations such as addition, subtraction, multiplication,
+ * determinant calculation, transpose, and more. Matrices up to INLINE_SIZE x INLINE_SIZE
+ * are stored inside the object itself and never touch the heap.
  * 
- * This class implements a square matrix with dynamic memory allocation
- * and provides various operations such as addition, subtraction, multiplication,
- * determinant calculation, transpose, and more.
+ * Operations never mix element types implicitly; convert with the explicit
+ * converting constructor first (e.g. SquareMat(intMatrix) + doubleMatrix).
+ * 
+ * @tparam T Element type; instantiated for float, double, std::int32_t and std::int64_t
  */
-class SquareMat {
+template <typename T>
+class BasicSquareMat {
+    template <typename U>
+    friend class BasicSquareMat;
+
+public:
+    static constexpr std::size_t ALIGNMENT = 64;  ///< Byte alignment of the element buffer
+    static constexpr int INLINE_SIZE = 4;          ///< Largest dimension stored inline, without heap
+    static constexpr std::size_t ALIASING_PERIOD = 512;  ///< Row pitch (bytes) whose multiples get an extra cache line
+
 private:
     /**
      * @class RowProxy
@@ -33,7 +67,7 @@ private:
      */
     class RowProxy {
     private:
-        double* row;
+        T* row;
         int size;
     public:
         /**
@@ -42,16 +76,16 @@ private:
          * @param row Pointer to the row data
          * @param size Size of the row
          */
-        RowProxy(double* row, int size) : row(row), size(size) {}
+        RowProxy(T* row, int size) : row(row), size(size) {}
         
         /**
          * @brief Access element at specified column index with bounds checking
          * 
          * @param col Column index
-         * @return double& Reference to the element
+         * @return T& Reference to the element
          * @throw std::out_of_range if index is out of bounds
          */
-        double& operator[](int col) {
+        T& operator[](int col) {
             if (col < 0 || col >= size) {
                 throw std::out_of_range("Column index out of range");
             }
@@ -62,10 +96,10 @@ private:
          * @brief Access element at specified column index with bounds checking (const version)
          * 
          * @param col Column index
-         * @return const double& Const reference to the element
+         * @return const T& Const reference to the element
          * @throw std::out_of_range if index is out of bounds
          */
-        const double& operator[](int col) const {
+        const T& operator[](int col) const {
             if (col < 0 || col >= size) {
                 throw std::out_of_range("Column index out of range");
             }
@@ -73,75 +107,362 @@ private:
         }
     };
 
-    double** matrix;  ///< 2D array to store matrix elements
+    alignas(ALIGNMENT) T local[INLINE_SIZE * INLINE_SIZE];  ///< Inline storage for small matrices
+    T* heap;     ///< Contiguous row-major heap buffer (nullptr when stored inline)
     int size;         ///< Size of the square matrix (n x n)
+    int stride;       ///< Leading dimension: distance (in elements) between the starts of consecutive rows.
+                      ///< Determined by size and T alone, so equal-size operands share it
+    std::pmr::memory_resource* resource;  ///< Memory resource the buffer is drawn from
+
+    /**
+     * @brief Get the row-major element buffer, inline or on the heap
+     * 
+     * The inline buffer is addressed through this accessor rather than a stored
+     * pointer, so the object holds no pointer into itself and can be relocated
+     * with a plain byte copy.
+     * 
+     * @return T* Pointer to the first element
+     */
+    T* elements() { return heap != nullptr ? heap : local; }
+
+    /**
+     * @brief Get the row-major element buffer, inline or on the heap (const version)
+     * 
+     * @return const T* Pointer to the first element
+     */
+    const T* elements() const { return heap != nullptr ? heap : local; }
+
+    /**
+     * @brief Compute the padded leading dimension used for an n x n matrix
+     * 
+     * Heap rows are rounded up to whole cache lines, and a further line is added
+     * when the row pitch is a multiple of ALIASING_PERIOD, so column walks over
+     * power-of-two sized matrices do not thrash the same cache sets.
+     * 
+     * @param n Size of the matrix
+     * @return int Leading dimension in elements (n for inline matrices)
+     */
+    static int paddedStride(int n);
+
+    /**
+     * @brief Set the dimensions and obtain storage for an n x n matrix
+     * 
+     * Matrices up to INLINE_SIZE use the inline buffer; larger ones allocate.
+     * Any previously held heap buffer must already have been released.
+     * 
+     * @param n Size of the matrix
+     */
+    void acquireStorage(int n);
+
+    /**
+     * @brief Release the heap buffer, if any
+     */
+    void releaseStorage();
 
     /**
      * @brief Calculate the sum of all elements in the matrix
      * 
-     * @return double Sum of all elements
+     * @return T Sum of all elements
      */
-    double sum() const;
+    T sum() const;
 
     /**
     * @brief Returns the remainder of a divided by b, always non-negative if b > 0.
     * 
     * This function computes the mathematical modulo operation for doubles and integers,
-    * ensuring the result is always non-negative
+    * ensuring the result is always non-negative. Integer element types use exact
+    * integer arithmetic.
     * 
-    * @param a The dividend (double)
+    * @param a The dividend
     * @param b The divisor (int)
-    * @return double The remainder of a divided by b
+    * @return T The remainder of a divided by b
     */
-    double modulo(double a, int b) const;
+    T modulo(T a, int b) const;
 
     /**
      * @brief Helper function for determinant calculation
      * 
-     * @param mat Matrix for which to calculate determinant
-     * @param n Size of the matrix
-     * @return double Determinant value
+     * Computes the determinant of the minor formed by the rows listed in
+     * rows[0 .. n-1] and the columns listed in cols[0 .. n-1], without copying
+     * the minor. Each expansion step recurses on the minor that skips rows[0]
+     * and one column. cols is reordered during the recursion and restored
+     * before returning.
+     * 
+     * @param mat Row-major buffer of the full matrix
+     * @param ld Leading dimension (row stride) of the buffer
+     * @param rows Row indices of the minor, in order
+     * @param cols Column indices of the minor, in order
+     * @param n Size of the minor
+     * @return T Determinant value
+     */
+    static T determinantHelper(const T* mat, int ld, const int* rows, int* cols, int n);
+
+    /**
+     * @brief Check whether a view shares any memory with this matrix's buffer
+     * 
+     * @param other View to check
+     * @return true if some element of other lies inside this matrix's buffer
+     */
+    bool overlaps(MatrixView<const T> other) const;
+
+    /**
+     * @brief Compute result = a * b with the engine selected by gemm::algorithm()
+     * 
+     * result must already have the size of the operands and must not overlap them.
+     * 
+     * @param a Left operand
+     * @param b Right operand
+     * @param result Destination, overwritten
+     * @param threads Number of threads to use (0 for the process-wide setting)
+     */
+    static void product(MatrixView<const T> a, MatrixView<const T> b, BasicSquareMat& result, int threads);
+
+    /**
+     * @brief Raise the matrix to a power by binary exponentiation
+     * 
+     * @param exponent Power to raise to
+     * @return BasicSquareMat Result of power operation
+     */
+    BasicSquareMat powerBySquaring(std::uint64_t exponent) const;
+
+    /**
+     * @brief Raise the matrix to a power through its characteristic polynomial
+     * 
+     * @param exponent Power to raise to
+     * @return BasicSquareMat Result of power operation
+     */
+    BasicSquareMat powerByCayleyHamilton(std::uint64_t exponent) const;
+
+    /**
+     * @brief Allocate an aligned, uninitialized element buffer from this matrix's resource
+     * 
+     * Buffers on the global heap are taken from the thread-local BufferPool when possible.
+     * 
+     * @param count Number of elements
+     * @return T* Pointer to the buffer (ALIGNMENT-byte aligned)
      */
-    double determinantHelper(double** mat, int n) const;
+    T* allocate(int count) const;
 
+    /**
+     * @brief Return a buffer obtained from allocate() to this matrix's resource
+     * 
+     * Buffers on the global heap are offered to the thread-local BufferPool first.
+     * 
+     * @param ptr Buffer to release (may be nullptr)
+     * @param count Number of elements the buffer was allocated with
+     */
+    void deallocate(T* ptr, int count) const;
+
+    /**
+     * @brief Validate a memory resource passed to a constructor
+     * 
+     * @param resource Memory resource
+     * @return std::pmr::memory_resource* resource, unchanged
+     * @throw std::invalid_argument if resource is nullptr
+     */
+    static std::pmr::memory_resource* checkedResource(std::pmr::memory_resource* resource);
 
 public:
     /**
      * @brief Construct a new Square Mat object initialized to zeros
      * 
+     * The element buffer is drawn from the given memory resource. Any custom
+     * allocator can be plugged in by wrapping it in a std::pmr::memory_resource;
+     * a std::pmr::monotonic_buffer_resource gives request-scoped arenas.
+     * The resource must outlive the matrix.
+     * 
      * @param size Size of the square matrix
+     * @param resource Memory resource for the element buffer (defaults to the
+     *        current std::pmr default resource)
      * @throw std::length_error if size is less than or equal to 0
+     * @throw std::invalid_argument if resource is nullptr
      */
-    explicit SquareMat(int size);
+    explicit BasicSquareMat(int size, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
      * @brief Copy constructor
      * 
+     * The copy draws its buffer from the same memory resource as other.
+     * 
+     * @param other Matrix to copy
+     */
+    BasicSquareMat(const BasicSquareMat& other);
+
+    /**
+     * @brief Copy constructor onto a different memory resource
+     * 
      * @param other Matrix to copy
+     * @param resource Memory resource for the copy's element buffer
+     * @throw std::invalid_argument if resource is nullptr
      */
-    SquareMat(const SquareMat& other);
+    BasicSquareMat(const BasicSquareMat& other, std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Construct a matrix holding a copy of a viewed block
+     * 
+     * @param source View of the elements to copy (e.g. a block or an external buffer)
+     * @param resource Memory resource for the element buffer
+     * @throw std::invalid_argument if resource is nullptr
+     */
+    explicit BasicSquareMat(MatrixView<const T> source, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Explicit converting constructor from a matrix of another element type
+     * 
+     * Each element is converted with static_cast, so narrowing conversions
+     * (e.g. double to int) truncate. The copy draws its buffer from the same
+     * memory resource as other.
+     * 
+     * @tparam U Element type of the source matrix
+     * @param other Matrix to convert
+     */
+    template <typename U>
+    explicit BasicSquareMat(const BasicSquareMat<U>& other) : heap(nullptr), resource(other.resource) {
+        acquireStorage(other.size);
+        const U* src = other.elements();
+        T* dst = elements();
+        std::fill(dst, dst + size * stride, T());
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                dst[i * stride + j] = static_cast<T>(src[i * other.stride + j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Move constructor
+     * 
+     * Steals the element buffer (and its memory resource) of other in O(1).
+     * other is left as an empty (size 0) matrix that may only be destroyed or assigned to.
+     * 
+     * @param other Matrix to move from
+     */
+    BasicSquareMat(BasicSquareMat&& other) noexcept;
 
     /**
      * @brief Destructor
      */
-    ~SquareMat();
+    ~BasicSquareMat();
 
     /**
      * @brief Copy assignment operator
      * 
      * @param other Matrix to copy
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
+     */
+    BasicSquareMat& operator=(const BasicSquareMat& other);
+
+    /**
+     * @brief Move assignment operator
+     * 
+     * Like std::pmr containers, the matrix keeps its own memory resource. If
+     * other's resource compares equal, this releases its buffer and takes over
+     * other's in O(1), leaving other an empty (size 0) matrix. Otherwise the
+     * elements are copied into this matrix's resource and other is unchanged.
+     * 
+     * @param other Matrix to move from
+     * @return BasicSquareMat& Reference to this matrix
      */
-    SquareMat& operator=(const SquareMat& other);
+    BasicSquareMat& operator=(BasicSquareMat&& other);
 
     /**
      * @brief Create an identity matrix of specified size
      * 
      * @param size Size of the identity matrix
-     * @return SquareMat Identity matrix
+     * @param resource Memory resource for the element buffer
+     * @return BasicSquareMat Identity matrix
      * @throw std::length_error if size is less than or equal to 0
      */
-    static SquareMat identity(int size);
+    static BasicSquareMat identity(int size, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Get the size of the matrix
+     * 
+     * @return int Number of rows (and columns); 0 for a moved-from matrix
+     */
+    int dimension() const { return size; }
+
+    /**
+     * @brief Get the leading dimension (row stride) of the element buffer
+     * 
+     * Element (i, j) lives at offset i * leadingDimension() + j from &(*this)[0][0].
+     * 
+     * @return int Distance in elements between the starts of consecutive rows
+     */
+    int leadingDimension() const { return stride; }
+
+    /**
+     * @brief Get a view of the whole matrix
+     * 
+     * @return MatrixView<T> View sharing this matrix's buffer
+     */
+    MatrixView<T> view();
+
+    /**
+     * @brief Get a read-only view of the whole matrix
+     * 
+     * @return MatrixView<const T> View sharing this matrix's buffer
+     */
+    MatrixView<const T> view() const;
+
+    /**
+     * @brief Get a view of an n x n sub-block without copying
+     * 
+     * @param row Row of the block's top-left element
+     * @param col Column of the block's top-left element
+     * @param n Size of the block
+     * @return MatrixView<T> View sharing this matrix's buffer
+     * @throw std::out_of_range if the block does not fit inside the matrix
+     */
+    MatrixView<T> block(int row, int col, int n);
+
+    /**
+     * @brief Get a read-only view of an n x n sub-block without copying
+     * 
+     * @param row Row of the block's top-left element
+     * @param col Column of the block's top-left element
+     * @param n Size of the block
+     * @return MatrixView<const T> View sharing this matrix's buffer
+     * @throw std::out_of_range if the block does not fit inside the matrix
+     */
+    MatrixView<const T> block(int row, int col, int n) const;
+
+    /**
+     * @brief Transpose a viewed block into a new matrix
+     * 
+     * @param source View to transpose
+     * @param resource Memory resource for the result
+     * @return BasicSquareMat Transposed copy of the view
+     */
+    static BasicSquareMat transpose(MatrixView<const T> source, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Calculate the determinant of a viewed block
+     * 
+     * Uses cofactor expansion that walks the minors in place, without copying them.
+     * 
+     * @param source View of the matrix
+     * @return T Determinant value
+     */
+    static T determinant(MatrixView<const T> source);
+
+    /**
+     * @brief Calculate the determinant of a minor (one row and column of a view skipped)
+     * 
+     * @param source View of the minor
+     * @return T Determinant value
+     */
+    static T determinant(MinorView<const T> source);
+
+    /**
+     * @brief Get the memory resource this matrix allocates from
+     * 
+     * Results of arithmetic operators are allocated from the resource of
+     * their left operand.
+     * 
+     * @return std::pmr::memory_resource* The memory resource
+     */
+    std::pmr::memory_resource* memoryResource() const { return resource; }
 
     /**
      * @brief Access row at specified index with bounds checking
@@ -165,122 +486,385 @@ public:
      * @brief Add two matrices
      * 
      * @param other Matrix to add
-     * @return SquareMat Result of addition
+     * @return BasicSquareMat Result of addition
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator+(const BasicSquareMat& other) const &;
+
+    /**
+     * @brief Add two matrices (left operand is a temporary)
+     * 
+     * Writes the result into the expiring left operand's buffer instead of allocating.
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing this matrix's storage
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator+(const BasicSquareMat& other) &&;
+
+    /**
+     * @brief Add two matrices (right operand is a temporary)
+     * 
+     * Writes the result into the expiring right operand's buffer instead of
+     * allocating when other's memory resource equals this matrix's; otherwise
+     * the result is allocated from this matrix's resource.
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing other's storage when the resources match
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator+(BasicSquareMat&& other) const &;
+
+    /**
+     * @brief Add two matrices (both operands are temporaries)
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing this matrix's storage
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat operator+(const SquareMat& other) const;
+    BasicSquareMat operator+(BasicSquareMat&& other) &&;
+
+    /**
+     * @brief Add a viewed block (no copy of the view is made)
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat Result of the operation
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat operator+(MatrixView<const T> other) const;
 
     /**
      * @brief Subtract two matrices
      * 
      * @param other Matrix to subtract
-     * @return SquareMat Result of subtraction
+     * @return BasicSquareMat Result of subtraction
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator-(const BasicSquareMat& other) const &;
+
+    /**
+     * @brief Subtract two matrices (left operand is a temporary)
+     * 
+     * Writes the result into the expiring left operand's buffer instead of allocating.
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing this matrix's storage
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator-(const BasicSquareMat& other) &&;
+
+    /**
+     * @brief Subtract two matrices (right operand is a temporary)
+     * 
+     * Writes the result into the expiring right operand's buffer instead of
+     * allocating when other's memory resource equals this matrix's; otherwise
+     * the result is allocated from this matrix's resource.
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing other's storage when the resources match
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator-(BasicSquareMat&& other) const &;
+
+    /**
+     * @brief Subtract two matrices (both operands are temporaries)
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing this matrix's storage
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat operator-(const SquareMat& other) const;
+    BasicSquareMat operator-(BasicSquareMat&& other) &&;
+
+    /**
+     * @brief Subtract a viewed block (no copy of the view is made)
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat Result of the operation
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat operator-(MatrixView<const T> other) const;
 
     /**
      * @brief Negate all elements of the matrix
      * 
-     * @return SquareMat Negated matrix
+     * @return BasicSquareMat Negated matrix
+     */
+    BasicSquareMat operator-() const &;
+
+    /**
+     * @brief Negate all elements in place on an expiring matrix
+     * 
+     * @return BasicSquareMat Negated matrix, reusing this matrix's storage
      */
-    SquareMat operator-() const;
+    BasicSquareMat operator-() &&;
 
     /**
      * @brief Multiply two matrices
      * 
+     * Uses the algorithm selected with gemm::setAlgorithm() (classical by default).
+     * 
      * @param other Matrix to multiply with
-     * @return SquareMat Result of multiplication
+     * @return BasicSquareMat Result of multiplication
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat operator*(const SquareMat& other) const;
+    BasicSquareMat operator*(const BasicSquareMat& other) const;
+
+    /**
+     * @brief Multiply by a viewed block (no copy of the view is made)
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat Result of the operation
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat operator*(MatrixView<const T> other) const;
+
+    /**
+     * @brief Multiply by a viewed block using a specific number of threads
+     * 
+     * operator* uses the process-wide setting of gemm::setThreadCount(); this
+     * overrides it for a single product. Products smaller than
+     * gemm::PARALLEL_PRODUCT_LIMIT always run on the calling thread.
+     * 
+     * @param other View of the right operand
+     * @param threads Number of threads to use (0 for the process-wide setting)
+     * @return BasicSquareMat Result of multiplication
+     * @throw std::invalid_argument if sizes differ or threads is negative
+     */
+    BasicSquareMat multiply(MatrixView<const T> other, int threads) const;
+
+    /**
+     * @brief Multiply the matrix by its own transpose (A * ~A)
+     * 
+     * Equals *this * ~*this, but never forms the transpose and computes only
+     * one triangle of the symmetric result, about half the work of the general
+     * product. See gemm::gram().
+     * 
+     * @param threads Number of threads to use (0 for the process-wide setting)
+     * @return BasicSquareMat Symmetric product
+     * @throw std::invalid_argument if threads is negative
+     */
+    BasicSquareMat gram(int threads = 0) const;
 
     /**
      * @brief Multiply matrix by scalar
      * 
      * @param scalar Scalar value
-     * @return SquareMat Result of multiplication
+     * @return BasicSquareMat Result of multiplication
+     */
+    BasicSquareMat operator*(T scalar) const &;
+
+    /**
+     * @brief Multiply by scalar in place on an expiring matrix
+     * 
+     * @param scalar Scalar value
+     * @return BasicSquareMat Result of multiplication, reusing this matrix's storage
      */
-    SquareMat operator*(double scalar) const;
+    BasicSquareMat operator*(T scalar) &&;
 
     /**
      * @brief Multiplies each element in one matrix by the 
      *        corresponding element in the second matrix.
      * 
      * @param other Matrix for element-wise multiplication
-     * @return SquareMat Result of element-wise multiplication
+     * @return BasicSquareMat Result of element-wise multiplication
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator%(const BasicSquareMat& other) const &;
+
+    /**
+     * @brief Element-wise multiplication (left operand is a temporary)
+     * 
+     * Writes the result into the expiring left operand's buffer instead of allocating.
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing this matrix's storage
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator%(const BasicSquareMat& other) &&;
+
+    /**
+     * @brief Element-wise multiplication (right operand is a temporary)
+     * 
+     * Writes the result into the expiring right operand's buffer instead of
+     * allocating when other's memory resource equals this matrix's; otherwise
+     * the result is allocated from this matrix's resource.
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing other's storage when the resources match
+     * @throw std::invalid_argument if matrices have different sizes
+     */
+    BasicSquareMat operator%(BasicSquareMat&& other) const &;
+
+    /**
+     * @brief Element-wise multiplication (both operands are temporaries)
+     * 
+     * @param other Right operand
+     * @return BasicSquareMat Result, reusing this matrix's storage
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat operator%(const SquareMat& other) const;
+    BasicSquareMat operator%(BasicSquareMat&& other) &&;
+
+    /**
+     * @brief Element-wise multiply by a viewed block (no copy of the view is made)
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat Result of the operation
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat operator%(MatrixView<const T> other) const;
 
     /**
      * @brief Apply modulo operation with scalar to each element
      * 
      * @param scalar Scalar for modulo operation
-     * @return SquareMat Result of modulo operation
+     * @return BasicSquareMat Result of modulo operation
      * @throw std::invalid_argument if scalar is 0
      */
-    SquareMat operator%(int scalar) const;
+    BasicSquareMat operator%(int scalar) const &;
+
+    /**
+     * @brief Apply modulo with scalar in place on an expiring matrix
+     * 
+     * @param scalar Scalar for modulo operation
+     * @return BasicSquareMat Result of modulo operation, reusing this matrix's storage
+     * @throw std::invalid_argument if scalar is 0 or negative
+     */
+    BasicSquareMat operator%(int scalar) &&;
 
     /**
      * @brief Divide matrix by scalar
      * 
      * @param scalar Scalar divisor
-     * @return SquareMat Result of division
+     * @return BasicSquareMat Result of division
      * @throw std::invalid_argument if scalar is 0 or negative 
      */
-    SquareMat operator/(double scalar) const;
+    BasicSquareMat operator/(T scalar) const &;
+
+    /**
+     * @brief Divide by scalar in place on an expiring matrix
+     * 
+     * @param scalar Scalar divisor
+     * @return BasicSquareMat Result of division, reusing this matrix's storage
+     * @throw std::invalid_argument if scalar is 0
+     */
+    BasicSquareMat operator/(T scalar) &&;
+
+    /**
+     * @brief Calculate the inverse matrix
+     * 
+     * Floating-point matrices are factorized once (LU with partial pivoting)
+     * and all columns of the identity are solved for with row operations; a
+     * pivot counts as zero when it is negligible next to both its row and its
+     * column, so scaling rows or columns does not make a matrix singular.
+     * Integer matrices are eliminated exactly with fraction-free (Bareiss)
+     * Gauss-Jordan steps in 128-bit arithmetic, which yields the determinant
+     * and the adjugate; only unimodular matrices (determinant +-1) have an
+     * integer inverse.
+     * 
+     * @return BasicSquareMat The inverse
+     * @throw std::invalid_argument if the matrix is singular (a floating-point pivot is zero to working
+     *        precision, or an integer determinant is 0), or an integer matrix has no integer inverse
+     * @throw std::overflow_error if an integer minor does not fit in 128 bits
+     */
+    BasicSquareMat inverse() const;
+
+    /**
+     * @brief Raise matrix to an integer power
+     * 
+     * Uses binary exponentiation: about log2(|power|) squarings plus one product
+     * per set bit of power, ping-ponging between preallocated buffers. A negative
+     * power inverts the matrix once and raises the inverse to -power.
+     * 
+     * @param power Power to raise to
+     * @return BasicSquareMat Result of power operation
+     * @throw std::invalid_argument if power is negative and the matrix has no inverse (see inverse())
+     */
+    BasicSquareMat operator^(int power) const;
+
+    /**
+     * @brief Raise matrix to a non-negative power with a selectable strategy
+     * 
+     * Cayley-Hamilton: with the characteristic polynomial chi of degree n,
+     * A^p = r(A) where r = x^p mod chi has degree < n. r is found by binary
+     * exponentiation of polynomials (O(n^2 log p) scalar work) and evaluated
+     * with Horner's rule, so the matrix work is about 2n products whatever p is.
+     * The polynomial comes from Faddeev-LeVerrier, which is exact for integer
+     * elements but can lose accuracy on floating-point matrices whose
+     * eigenvalues differ in magnitude, so Automatic only picks it for integer
+     * element types.
+     * 
+     * @param exponent Power to raise to
+     * @param strategy Evaluation strategy; Automatic uses selectPowerStrategy()
+     * @return BasicSquareMat Result of power operation
+     */
+    BasicSquareMat power(std::uint64_t exponent, PowerStrategy strategy = PowerStrategy::Automatic) const;
+
+    /**
+     * @brief Choose the power strategy with fewer matrix products
+     * 
+     * Squaring needs floor(log2 p) squarings plus popcount(p) - 1 products;
+     * Cayley-Hamilton needs 2n - 2 (characteristic polynomial and Horner
+     * evaluation). Ties go to squaring, and floating-point element types always
+     * get squaring, since Cayley-Hamilton is only exact for integers.
+     * 
+     * @param size Dimension of the matrix
+     * @param exponent Power to raise to
+     * @return PowerStrategy Squaring or CayleyHamilton
+     */
+    static PowerStrategy selectPowerStrategy(int size, std::uint64_t exponent);
 
     /**
-     * @brief Raise matrix to a non-negative integer power
+     * @brief Compute the characteristic polynomial det(x I - A)
+     * 
+     * Uses the Faddeev-LeVerrier recurrence (n - 1 matrix products). Every
+     * division in it is exact for integer matrices, so integer coefficients
+     * are exact unless they overflow.
      * 
-     * @param power Power to raise to (must be >= 0)
-     * @return SquareMat Result of power operation
-     * @throw std::invalid_argument if power is negative
+     * @return std::vector<T> Coefficients c[0..n], lowest degree first, with c[n] = 1
      */
-    SquareMat operator^(int power) const;
+    std::vector<T> characteristicPolynomial() const;
 
     /**
      * @brief Pre-increment operator (add 1 to all elements)
      * 
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      */
-    SquareMat& operator++();
+    BasicSquareMat& operator++();
 
     /**
      * @brief Post-increment operator (add 1 to all elements)
      * 
-     * @return SquareMat Copy of matrix before increment
+     * @return BasicSquareMat Copy of matrix before increment
      */
-    SquareMat operator++(int);
+    BasicSquareMat operator++(int);
 
     /**
      * @brief Pre-decrement operator (subtract 1 from all elements)
      * 
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      */
-    SquareMat& operator--();
+    BasicSquareMat& operator--();
 
     /**
      * @brief Post-decrement operator (subtract 1 from all elements)
      * 
-     * @return SquareMat Copy of matrix before decrement
+     * @return BasicSquareMat Copy of matrix before decrement
      */
-    SquareMat operator--(int);
+    BasicSquareMat operator--(int);
 
     /**
      * @brief Transpose the matrix
      * 
-     * @return SquareMat Transposed matrix
+     * @return BasicSquareMat Transposed matrix
      */
-    SquareMat operator~() const;
+    BasicSquareMat operator~() const;
 
     /**
      * @brief Calculate determinant of the matrix
      * 
-     * @return double Determinant value
+     * @return T Determinant value
      */
-    double operator!() const;
+    T operator!() const;
 
     /**
      * @brief Check if two matrices have equal sum of elements
@@ -288,7 +872,7 @@ public:
      * @param other Matrix to compare with
      * @return bool True if sums are equal
      */
-    bool operator==(const SquareMat& other) const;
+    bool operator==(const BasicSquareMat& other) const;
 
     /**
      * @brief Check if two matrices have different sum of elements
@@ -296,7 +880,7 @@ public:
      * @param other Matrix to compare with
      * @return bool True if sums are different
      */
-    bool operator!=(const SquareMat& other) const;
+    bool operator!=(const BasicSquareMat& other) const;
 
     /**
      * @brief Check if sum of elements is less than other matrix
@@ -304,7 +888,7 @@ public:
      * @param other Matrix to compare with
      * @return bool True if sum is less
      */
-    bool operator<(const SquareMat& other) const;
+    bool operator<(const BasicSquareMat& other) const;
 
     /**
      * @brief Check if sum of elements is greater than other matrix
@@ -312,7 +896,7 @@ public:
      * @param other Matrix to compare with
      * @return bool True if sum is greater
      */
-    bool operator>(const SquareMat& other) const;
+    bool operator>(const BasicSquareMat& other) const;
 
     /**
      * @brief Check if sum of elements is less than or equal to other matrix
@@ -320,7 +904,7 @@ public:
      * @param other Matrix to compare with
      * @return bool True if sum is less or equal
      */
-    bool operator<=(const SquareMat& other) const;
+    bool operator<=(const BasicSquareMat& other) const;
 
     /**
      * @brief Check if sum of elements is greater than or equal to other matrix
@@ -328,78 +912,150 @@ public:
      * @param other Matrix to compare with
      * @return bool True if sum is greater or equal
      */
-    bool operator>=(const SquareMat& other) const;
+    bool operator>=(const BasicSquareMat& other) const;
 
     /**
      * @brief Add and assign another matrix
      * 
      * @param other Matrix to add
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat& operator+=(const SquareMat& other);
+    BasicSquareMat& operator+=(const BasicSquareMat& other);
+
+    /**
+     * @brief Add a viewed block and assign
+     * 
+     * The view must not overlap this matrix.
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat& Reference to this matrix
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat& operator+=(MatrixView<const T> other);
 
     /**
      * @brief Subtract and assign another matrix
      * 
      * @param other Matrix to subtract
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat& operator-=(const SquareMat& other);
+    BasicSquareMat& operator-=(const BasicSquareMat& other);
+
+    /**
+     * @brief Subtract a viewed block and assign
+     * 
+     * The view must not overlap this matrix.
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat& Reference to this matrix
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat& operator-=(MatrixView<const T> other);
 
     /**
      * @brief Multiply and assign with another matrix
      * 
      * @param other Matrix to multiply with
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat& operator*=(const SquareMat& other);
+    BasicSquareMat& operator*=(const BasicSquareMat& other);
+
+    /**
+     * @brief Multiply by a viewed block and assign
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat& Reference to this matrix
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat& operator*=(MatrixView<const T> other);
 
     /**
      * @brief Multiply and assign with scalar
      * 
      * @param scalar Scalar value
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      */
-    SquareMat& operator*=(double scalar);
+    BasicSquareMat& operator*=(T scalar);
 
     /**
      * @brief Element-wise multiply and assign with another matrix
      * 
      * @param other Matrix for element-wise multiplication
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      * @throw std::invalid_argument if matrices have different sizes
      */
-    SquareMat& operator%=(const SquareMat& other);
+    BasicSquareMat& operator%=(const BasicSquareMat& other);
+
+    /**
+     * @brief Element-wise multiply by a viewed block and assign
+     * 
+     * The view must not overlap this matrix.
+     * 
+     * @param other View of the right operand
+     * @return BasicSquareMat& Reference to this matrix
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat& operator%=(MatrixView<const T> other);
 
     /**
      * @brief Apply modulo operation with scalar and assign
      * 
      * @param scalar Scalar for modulo operation
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      * @throw std::invalid_argument if scalar is 0
      */
-    SquareMat& operator%=(int scalar);
+    BasicSquareMat& operator%=(int scalar);
 
     /**
      * @brief Divide by scalar and assign
      * 
      * @param scalar Scalar divisor
-     * @return SquareMat& Reference to this matrix
+     * @return BasicSquareMat& Reference to this matrix
      * @throw std::invalid_argument if scalar is 0
      */
-    SquareMat& operator/=(double scalar);
+    BasicSquareMat& operator/=(T scalar);
+
+    /**
+     * @brief Accumulate a scaled product in place: this = alpha * a * b + beta * this
+     * 
+     * The product is written straight into this matrix's buffer, so an update
+     * such as C += 0.5 * A * B (c.gemm(0.5, a, b)) needs no temporaries. If a
+     * or b overlaps this matrix, the product is formed in a temporary first.
+     * Always uses the classical kernel, whatever gemm::algorithm() is.
+     * 
+     * @param alpha Scale of the product
+     * @param a View of the left factor
+     * @param b View of the right factor
+     * @param beta Scale of the current contents (1 accumulates, 0 overwrites)
+     * @return BasicSquareMat& Reference to this matrix
+     * @throw std::invalid_argument if sizes differ
+     */
+    BasicSquareMat& gemm(T alpha, MatrixView<const T> a, MatrixView<const T> b, T beta = T(1));
 
     /**
      * @brief Friend function for scalar * matrix multiplication
      * 
      * @param scalar Scalar value
      * @param mat Matrix to multiply
-     * @return SquareMat Result of multiplication
+     * @return BasicSquareMat Result of multiplication
      */
-    friend SquareMat operator*(double scalar, const SquareMat& mat);
+    friend BasicSquareMat operator*(T scalar, const BasicSquareMat& mat) {
+        return mat * scalar;
+    }
+
+    /**
+     * @brief Friend function for scalar * matrix multiplication on a temporary
+     * 
+     * @param scalar Scalar value
+     * @param mat Expiring matrix to multiply
+     * @return BasicSquareMat Result of multiplication, reusing mat's storage
+     */
+    friend BasicSquareMat operator*(T scalar, BasicSquareMat&& mat) {
+        return std::move(mat) * scalar;
+    }
 
     /**
      * @brief Friend function for matrix output
@@ -408,7 +1064,27 @@ public:
      * @param mat Matrix to output
      * @return std::ostream& Reference to output stream
      */
-    friend std::ostream& operator<<(std::ostream& os, const SquareMat& mat);
+    friend std::ostream& operator<<(std::ostream& os, const BasicSquareMat& mat) {
+        const T* buffer = mat.elements();
+        for (int i = 0; i < mat.size; ++i) {
+            os << "| " <<" ";
+            for (int j = 0; j < mat.size; ++j) {
+                os << buffer[i * mat.stride + j]<<" ";
+            }
+            os << " |" << std::endl;
+        }
+        return os;
+    }
 };
 
+extern template class BasicSquareMat<float>;
+extern template class BasicSquareMat<double>;
+extern template class BasicSquareMat<std::int32_t>;
+extern template class BasicSquareMat<std::int64_t>;
+
+using SquareMat = BasicSquareMat<double>;         ///< Double-precision square matrix
+using SquareMatF = BasicSquareMat<float>;         ///< Single-precision square matrix
+using SquareMatI32 = BasicSquareMat<std::int32_t>;  ///< 32-bit integer square matrix
+using SquareMatI64 = BasicSquareMat<std::int64_t>;  ///< 64-bit integer square matrix
+
 } // namespace matrix_ops
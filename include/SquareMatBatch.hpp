@@ -0,0 +1,254 @@
+// idocohen963@gmail.com
+/**
+ * @file SquareMatBatch.hpp
+ * @brief Header file for the BasicSquareMatBatch class template, K same-sized matrices in SoA layout
+ *
+ * Workloads such as transform chains multiply huge numbers of independent 3x3
+ * or 4x4 matrices. One BasicSquareMat per matrix spends most of its time in
+ * allocation and loop overhead, and its n-element loops are too short to
+ * vectorize. A batch instead stores element (row, col) of all K matrices
+ * contiguously, so every batched operation is a sequence of long, unit-stride
+ * loops across the batch that the compiler vectorizes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include "SquareMat.hpp"
+#include "Vector.hpp"
+#include <stdexcept>
+
+namespace matrix_ops {
+
+/**
+ * @class BasicSquareMatBatch
+ * @brief A batch of count independent size x size matrices in struct-of-arrays layout
+ *
+ * Element (row, col) of matrix k is stored at plane(row, col)[k]. Each plane
+ * holds pitch() >= count() elements and starts on a cache line boundary; the
+ * padding lanes hold zeros and are never observable.
+ *
+ * @tparam T Element type; instantiated for float, double, std::int32_t and std::int64_t
+ */
+template <typename T>
+class BasicSquareMatBatch {
+public:
+    static constexpr std::size_t ALIGNMENT = BasicSquareMat<T>::ALIGNMENT;           ///< Byte alignment of every plane
+    static constexpr int LANES = static_cast<int>(ALIGNMENT / sizeof(T));            ///< Elements per cache line
+
+private:
+    T* values;                            ///< size * size planes of pitch elements each
+    int size;                             ///< Dimension of every matrix
+    int matrices;                         ///< Number of matrices in the batch
+    int pitch;                            ///< Elements per plane (matrices rounded up to LANES)
+    std::pmr::memory_resource* resource;  ///< Resource the buffer was allocated from
+
+    /**
+     * @brief Tag selecting the constructor that leaves the planes uninitialized
+     */
+    struct Uninitialized {};
+
+    /**
+     * @brief Allocate (without initializing) the planes for a batch of the given shape
+     *
+     * @param n Dimension of every matrix
+     * @param count Number of matrices
+     */
+    void acquireStorage(int n, int count);
+
+    /**
+     * @brief Construct a batch whose planes, padding included, the caller fully overwrites
+     */
+    BasicSquareMatBatch(int size, int count, std::pmr::memory_resource* resource, Uninitialized);
+
+    /**
+     * @brief Return the buffer to the memory resource
+     */
+    void releaseStorage();
+
+    /**
+     * @brief Get the plane holding element (row, col) of every matrix (unchecked)
+     */
+    T* plane(int row, int col) { return values + (row * size + col) * pitch; }
+
+    /**
+     * @brief Get the plane holding element (row, col) of every matrix (unchecked, const version)
+     */
+    const T* plane(int row, int col) const { return values + (row * size + col) * pitch; }
+
+    /**
+     * @brief Throw unless other has the same dimension and count as this batch
+     *
+     * @param other Batch to compare with
+     * @param operation Name of the operation, used in the message
+     */
+    void requireSameShape(const BasicSquareMatBatch& other, const char* operation) const;
+
+public:
+    /**
+     * @brief Construct a batch of zero matrices
+     *
+     * @param size Dimension of every matrix
+     * @param count Number of matrices
+     * @param resource Memory resource for the element buffer
+     * @throw std::length_error if size or count is less than or equal to 0
+     * @throw std::invalid_argument if resource is nullptr
+     */
+    BasicSquareMatBatch(int size, int count, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Copy constructor
+     *
+     * @param other Batch to copy
+     */
+    BasicSquareMatBatch(const BasicSquareMatBatch& other);
+
+    /**
+     * @brief Move constructor
+     *
+     * other is left empty (count 0) and may only be destroyed or assigned to.
+     *
+     * @param other Batch to move from
+     */
+    BasicSquareMatBatch(BasicSquareMatBatch&& other) noexcept;
+
+    /**
+     * @brief Destructor
+     */
+    ~BasicSquareMatBatch();
+
+    /**
+     * @brief Copy assignment operator
+     *
+     * The copy is drawn from this batch's memory resource.
+     *
+     * @param other Batch to copy
+     * @return BasicSquareMatBatch& Reference to this batch
+     */
+    BasicSquareMatBatch& operator=(const BasicSquareMatBatch& other);
+
+    /**
+     * @brief Move assignment operator
+     *
+     * The batch keeps its own memory resource: other's buffer is taken over in
+     * O(1) only if the resources compare equal, and copied otherwise.
+     *
+     * @param other Batch to move from
+     * @return BasicSquareMatBatch& Reference to this batch
+     */
+    BasicSquareMatBatch& operator=(BasicSquareMatBatch&& other);
+
+    /**
+     * @brief Get the dimension of every matrix
+     *
+     * @return int Number of rows (and columns) of each matrix
+     */
+    int dimension() const { return size; }
+
+    /**
+     * @brief Get the number of matrices
+     *
+     * @return int Batch size; 0 for a moved-from batch
+     */
+    int count() const { return matrices; }
+
+    /**
+     * @brief Get the number of elements per plane, including padding lanes
+     *
+     * @return int Plane length (a multiple of LANES)
+     */
+    int planePitch() const { return pitch; }
+
+    /**
+     * @brief Access element (row, col) of matrix index with bounds checking
+     *
+     * @param index Matrix index within the batch
+     * @param row Row index
+     * @param col Column index
+     * @return T& Reference to the element
+     * @throw std::out_of_range if an index is out of bounds
+     */
+    T& operator()(int index, int row, int col);
+
+    /**
+     * @brief Access element (row, col) of matrix index with bounds checking (const version)
+     *
+     * @param index Matrix index within the batch
+     * @param row Row index
+     * @param col Column index
+     * @return const T& Reference to the element
+     * @throw std::out_of_range if an index is out of bounds
+     */
+    const T& operator()(int index, int row, int col) const;
+
+    /**
+     * @brief Copy one matrix out of the batch
+     *
+     * @param index Matrix index within the batch
+     * @return BasicSquareMat<T> Copy of the matrix
+     * @throw std::out_of_range if index is out of bounds
+     */
+    BasicSquareMat<T> get(int index) const;
+
+    /**
+     * @brief Overwrite one matrix of the batch
+     *
+     * @param index Matrix index within the batch
+     * @param mat Matrix to store
+     * @throw std::out_of_range if index is out of bounds
+     * @throw std::invalid_argument if mat has a different dimension
+     */
+    void set(int index, const BasicSquareMat<T>& mat);
+
+    /**
+     * @brief Multiply corresponding matrices of two batches
+     *
+     * @param other Batch of right operands
+     * @return BasicSquareMatBatch Batch of products
+     * @throw std::invalid_argument if dimensions or counts differ
+     */
+    BasicSquareMatBatch operator*(const BasicSquareMatBatch& other) const;
+
+    /**
+     * @brief Add corresponding matrices of two batches
+     *
+     * @param other Batch of right operands
+     * @return BasicSquareMatBatch Batch of sums
+     * @throw std::invalid_argument if dimensions or counts differ
+     */
+    BasicSquareMatBatch operator+(const BasicSquareMatBatch& other) const;
+
+    /**
+     * @brief Transpose every matrix of the batch
+     *
+     * In SoA layout this only permutes planes.
+     *
+     * @return BasicSquareMatBatch Batch of transposes
+     */
+    BasicSquareMatBatch operator~() const;
+
+    /**
+     * @brief Calculate the determinant of every matrix of the batch
+     *
+     * Dimensions 1 to 4 use closed forms evaluated across the batch; larger
+     * matrices fall back to BasicSquareMat::determinant one matrix at a time.
+     *
+     * @return BasicVector<T> Determinants, one per matrix
+     * @throw std::length_error if the batch is empty (moved-from)
+     */
+    BasicVector<T> operator!() const;
+};
+
+extern template class BasicSquareMatBatch<float>;
+extern template class BasicSquareMatBatch<double>;
+extern template class BasicSquareMatBatch<std::int32_t>;
+extern template class BasicSquareMatBatch<std::int64_t>;
+
+using SquareMatBatch = BasicSquareMatBatch<double>;           ///< Batch of double-precision matrices
+using SquareMatBatchF = BasicSquareMatBatch<float>;           ///< Batch of single-precision matrices
+using SquareMatBatchI32 = BasicSquareMatBatch<std::int32_t>;  ///< Batch of 32-bit integer matrices
+using SquareMatBatchI64 = BasicSquareMatBatch<std::int64_t>;  ///< Batch of 64-bit integer matrices
+
+} // namespace matrix_ops
@@ -0,0 +1,90 @@
+// idocohen963@gmail.com
+/**
+ * @file ThreadPool.hpp
+ * @brief Header file for the ThreadPool class, the process-wide pool of worker threads
+ *
+ * The parallel matrix kernels split their work into independent tasks and hand
+ * them to parallelFor(). The calling thread always takes part in the work, so a
+ * request for t threads uses t - 1 workers from the pool.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace matrix_ops {
+
+/**
+ * @class ThreadPool
+ * @brief A lazily grown pool of worker threads shared by all parallel kernels
+ *
+ * Workers are started on first demand and live until the program exits. Calls
+ * made from inside a task run serially on the calling worker, so nested
+ * parallel kernels cannot deadlock the pool.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Get the process-wide pool
+     *
+     * @return ThreadPool& The shared pool
+     */
+    static ThreadPool& instance();
+
+    /**
+     * @brief Get the number of hardware threads, at least 1
+     *
+     * @return int Value of std::thread::hardware_concurrency(), or 1 if unknown
+     */
+    static int hardwareThreads();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Destructor, stops and joins every worker
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Run body(0), ..., body(count - 1) on up to threads threads and wait for all of them
+     *
+     * Tasks are claimed dynamically, so uneven tasks balance out. If a task
+     * throws, the remaining unclaimed tasks are skipped and the first exception
+     * is rethrown on the calling thread.
+     *
+     * @param count Number of tasks
+     * @param threads Maximum number of threads to use, including the caller
+     * @param body Task function, called with the task index
+     */
+    void parallelFor(int count, int threads, const std::function<void(int)>& body);
+
+    /**
+     * @brief Get the number of worker threads started so far
+     *
+     * @return int Number of workers (not counting callers)
+     */
+    int workerCount() const;
+
+private:
+    struct Job;
+
+    std::vector<std::thread> workers;
+    std::deque<Job*> queue;   ///< One entry per helper slot still open
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    ThreadPool() = default;
+
+    void ensureWorkers(int count);
+    void workerLoop();
+    static void runTasks(Job& job);
+};
+
+} // namespace matrix_ops
@@ -0,0 +1,320 @@
+// idocohen963@gmail.com
+/**
+ * @file Vector.hpp
+ * @brief Header file for the BasicVector class template and matrix-vector products
+ *
+ * A BasicVector is a dense, cache-line aligned column of elements. Multiplying
+ * it by a BasicSquareMat costs O(n^2), instead of the O(n^3) of emulating the
+ * vector with an n x n matrix. Products, dot and axpy run on the bandwidth
+ * oriented kernels in Gemv.hpp.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include "SquareMat.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace matrix_ops {
+
+/**
+ * @class BasicVector
+ * @brief A dense vector of n elements
+ *
+ * @tparam T Element type; instantiated for float, double, std::int32_t and std::int64_t
+ */
+template <typename T>
+class BasicVector {
+private:
+    T* values;                            ///< Element buffer (ALIGNMENT-byte aligned), nullptr when empty
+    int size;                             ///< Number of elements
+    std::pmr::memory_resource* resource;  ///< Resource the buffer was allocated from
+
+    /**
+     * @brief Allocate and zero a buffer for n elements
+     *
+     * @param n Number of elements
+     */
+    void acquireStorage(int n);
+
+    /**
+     * @brief Return the buffer to the memory resource
+     */
+    void releaseStorage();
+
+public:
+    static constexpr std::size_t ALIGNMENT = BasicSquareMat<T>::ALIGNMENT;  ///< Byte alignment of the buffer
+
+    /**
+     * @brief Construct a vector of zeros
+     *
+     * @param size Number of elements
+     * @param resource Memory resource for the element buffer
+     * @throw std::length_error if size is less than or equal to 0
+     * @throw std::invalid_argument if resource is nullptr
+     */
+    explicit BasicVector(int size, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Copy constructor
+     *
+     * @param other Vector to copy
+     */
+    BasicVector(const BasicVector& other);
+
+    /**
+     * @brief Move constructor
+     *
+     * other is left as an empty (size 0) vector that may only be destroyed or assigned to.
+     *
+     * @param other Vector to move from
+     */
+    BasicVector(BasicVector&& other) noexcept;
+
+    /**
+     * @brief Destructor
+     */
+    ~BasicVector();
+
+    /**
+     * @brief Copy assignment operator
+     *
+     * @param other Vector to copy
+     * @return BasicVector& Reference to this vector
+     */
+    BasicVector& operator=(const BasicVector& other);
+
+    /**
+     * @brief Move assignment operator
+     *
+     * The vector keeps its own memory resource: other's buffer is taken over in
+     * O(1) only if the resources compare equal, and copied otherwise.
+     *
+     * @param other Vector to move from
+     * @return BasicVector& Reference to this vector
+     */
+    BasicVector& operator=(BasicVector&& other);
+
+    /**
+     * @brief Get the number of elements
+     *
+     * @return int Length of the vector; 0 for a moved-from vector
+     */
+    int dimension() const { return size; }
+
+    /**
+     * @brief Get a pointer to the first element
+     *
+     * @return T* Pointer to the element buffer
+     */
+    T* data() { return values; }
+
+    /**
+     * @brief Get a pointer to the first element (const version)
+     *
+     * @return const T* Pointer to the element buffer
+     */
+    const T* data() const { return values; }
+
+    /**
+     * @brief Access element at the given index with bounds checking
+     *
+     * @param index Element index
+     * @return T& Reference to the element
+     * @throw std::out_of_range if index is out of bounds
+     */
+    T& operator[](int index);
+
+    /**
+     * @brief Access element at the given index with bounds checking (const version)
+     *
+     * @param index Element index
+     * @return const T& Reference to the element
+     * @throw std::out_of_range if index is out of bounds
+     */
+    const T& operator[](int index) const;
+
+    /**
+     * @brief Add two vectors
+     *
+     * @param other Vector to add
+     * @return BasicVector Sum of the vectors
+     * @throw std::invalid_argument if lengths differ
+     */
+    BasicVector operator+(const BasicVector& other) const;
+
+    /**
+     * @brief Subtract two vectors
+     *
+     * @param other Vector to subtract
+     * @return BasicVector Difference of the vectors
+     * @throw std::invalid_argument if lengths differ
+     */
+    BasicVector operator-(const BasicVector& other) const;
+
+    /**
+     * @brief Multiply every element by a scalar
+     *
+     * @param scalar Scalar value
+     * @return BasicVector Scaled vector
+     */
+    BasicVector operator*(T scalar) const;
+
+    /**
+     * @brief Check element-wise equality
+     *
+     * @param other Vector to compare with
+     * @return true if both vectors have the same length and elements
+     */
+    bool operator==(const BasicVector& other) const;
+
+    /**
+     * @brief Check element-wise inequality
+     *
+     * @param other Vector to compare with
+     * @return true if the vectors differ in length or in some element
+     */
+    bool operator!=(const BasicVector& other) const;
+
+    /**
+     * @brief Compute the dot product with another vector
+     *
+     * @param other Second vector
+     * @return T Sum of the products of corresponding elements
+     * @throw std::invalid_argument if lengths differ
+     */
+    T dot(const BasicVector& other) const;
+
+    /**
+     * @brief Add a scaled vector in place: this = alpha * x + this
+     *
+     * @param alpha Scale of x
+     * @param x Vector to add
+     * @return BasicVector& Reference to this vector
+     * @throw std::invalid_argument if lengths differ
+     */
+    BasicVector& axpy(T alpha, const BasicVector& x);
+
+    /**
+     * @brief Friend function for scalar * vector multiplication
+     *
+     * @param scalar Scalar value
+     * @param vec Vector to multiply
+     * @return BasicVector Scaled vector
+     */
+    friend BasicVector operator*(T scalar, const BasicVector& vec) {
+        return vec * scalar;
+    }
+
+    /**
+     * @brief Friend function for vector output
+     *
+     * @param os Output stream
+     * @param vec Vector to output
+     * @return std::ostream& Reference to output stream
+     */
+    friend std::ostream& operator<<(std::ostream& os, const BasicVector& vec) {
+        os << "[ ";
+        for (int i = 0; i < vec.size; ++i) {
+            os << vec.values[i] << " ";
+        }
+        os << "]";
+        return os;
+    }
+};
+
+/**
+ * @brief Multiply a matrix by a column vector (A * x)
+ *
+ * @param mat Matrix A
+ * @param vec Vector x
+ * @return BasicVector<T> Product vector
+ * @throw std::invalid_argument if sizes differ
+ */
+template <typename T>
+BasicVector<T> operator*(const BasicSquareMat<T>& mat, const BasicVector<T>& vec);
+
+/**
+ * @brief Multiply a row vector by a matrix (x * A, which equals A^T * x)
+ *
+ * @param vec Vector x
+ * @param mat Matrix A
+ * @return BasicVector<T> Product vector
+ * @throw std::invalid_argument if sizes differ
+ */
+template <typename T>
+BasicVector<T> operator*(const BasicVector<T>& vec, const BasicSquareMat<T>& mat);
+
+/**
+ * @brief Cost of one matrix product, in matrix-vector products, per unit of dimension
+ *
+ * A product does n times the arithmetic of a matrix-vector product but runs from
+ * cache instead of memory bandwidth, so it costs about n / MATRIX_PRODUCT_SPEEDUP
+ * matrix-vector products.
+ */
+constexpr int MATRIX_PRODUCT_SPEEDUP = 16;
+
+/**
+ * @brief Decide whether A^p * x is cheaper by p repeated matrix-vector products
+ *
+ * Repeated products cost p * vectors matrix-vector products. Squaring costs
+ * floor(log2 p) matrix products (each n / MATRIX_PRODUCT_SPEEDUP of them) plus
+ * popcount(p) * vectors matrix-vector products.
+ *
+ * @param size Dimension of the matrix
+ * @param power Exponent p
+ * @param vectors Number of vectors multiplied
+ * @return true if repeated matrix-vector products are expected to be at least as fast
+ */
+bool preferRepeatedProducts(int size, std::uint64_t power, int vectors);
+
+/**
+ * @brief Compute A^p * x without forming A^p when that is cheaper
+ *
+ * Either applies A to x p times, O(p n^2), or squares A up to the top bit of p
+ * and applies the squarings selected by the bits of p to x, O(log p n^3);
+ * preferRepeatedProducts() picks one.
+ *
+ * @param mat Matrix A
+ * @param power Exponent p
+ * @param vec Vector x
+ * @param threads Number of threads to use (0 for gemm::threadCount())
+ * @return BasicVector<T> A^p * x
+ * @throw std::invalid_argument if sizes differ or threads is negative
+ */
+template <typename T>
+BasicVector<T> powerTimes(const BasicSquareMat<T>& mat, std::uint64_t power, const BasicVector<T>& vec,
+                          int threads = 0);
+
+/**
+ * @brief Compute A^p * x for each vector of a block
+ *
+ * Like the single-vector overload, but the strategy is chosen for the whole
+ * block, so the squarings are shared by every vector.
+ *
+ * @param mat Matrix A
+ * @param power Exponent p
+ * @param block Vectors x_1 .. x_k
+ * @param threads Number of threads to use (0 for gemm::threadCount())
+ * @return std::vector<BasicVector<T>> A^p * x_i, in the order of block
+ * @throw std::invalid_argument if some vector's size differs from the matrix, or threads is negative
+ */
+template <typename T>
+std::vector<BasicVector<T>> powerTimes(const BasicSquareMat<T>& mat, std::uint64_t power,
+                                       const std::vector<BasicVector<T>>& block, int threads = 0);
+
+extern template class BasicVector<float>;
+extern template class BasicVector<double>;
+extern template class BasicVector<std::int32_t>;
+extern template class BasicVector<std::int64_t>;
+
+using Vector = BasicVector<double>;           ///< Double-precision vector
+using VectorF = BasicVector<float>;           ///< Single-precision vector
+using VectorI32 = BasicVector<std::int32_t>;  ///< 32-bit integer vector
+using VectorI64 = BasicVector<std::int64_t>;  ///< 64-bit integer vector
+
+} // namespace matrix_ops
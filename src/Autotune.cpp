@@ -0,0 +1,251 @@
+// idocohen963@gmail.com
+
+#include "../include/Autotune.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace matrix_ops {
+namespace gemm {
+
+namespace {
+
+constexpr simd::Isa ALL_ISAS[] = {simd::Isa::Scalar, simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512};
+
+// Candidate values of each block size, tried one dimension at a time
+constexpr int KC_CANDIDATES[] = {128, 192, 256, 384, 512};
+constexpr int MC_CANDIDATES[] = {48, 96, 128, 192, 288};
+constexpr int NC_CANDIDATES[] = {512, 1024, 2048, 4096};
+
+/**
+ * @brief Operands and destination of the products timed by autotune()
+ */
+struct Workload {
+    int size;
+    int repetitions;
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<double> c;
+
+    Workload(int size, int repetitions)
+        : size(size), repetitions(repetitions), a(static_cast<std::size_t>(size) * size),
+          b(a.size()), c(a.size()) {
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            a[i] = static_cast<double>(i % 13) - 6.0;
+            b[i] = static_cast<double>(i % 7) * 0.5;
+        }
+    }
+
+    // Best time of the repetitions, in seconds, under the given configuration
+    double time(const TuningProfile& profile) {
+        applyProfile(profile);
+        double best = 0.0;
+        for (int r = 0; r < repetitions; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            multiply(size, 1.0, a.data(), size, b.data(), size, 0.0, c.data(), size);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (r == 0 || elapsed.count() < best) {
+                best = elapsed.count();
+            }
+        }
+        return best;
+    }
+};
+
+/**
+ * @brief Reapplies a saved profile on destruction unless dismissed
+ *
+ * Keeps a trial configuration from staying applied when a timed product throws.
+ */
+class ProfileRestorer {
+public:
+    explicit ProfileRestorer(const TuningProfile& saved) : saved(saved) {}
+    ProfileRestorer(const ProfileRestorer&) = delete;
+    ProfileRestorer& operator=(const ProfileRestorer&) = delete;
+
+    ~ProfileRestorer() {
+        if (active) {
+            // saved was in effect when the guard was created, so it passes validation
+            applyProfile(saved);
+        }
+    }
+
+    void dismiss() { active = false; }
+
+private:
+    TuningProfile saved;
+    bool active = true;
+};
+
+// Time every candidate for one block size and keep the fastest in profile
+template <std::size_t N>
+void tuneDimension(Workload& workload, TuningProfile& profile, int BlockSizes::*field, const int (&candidates)[N],
+                   double& bestTime) {
+    TuningProfile trial = profile;
+    for (int value : candidates) {
+        if (value == profile.blocks.*field) {
+            continue;  // Already timed
+        }
+        trial.blocks.*field = value;
+        double elapsed = workload.time(trial);
+        if (elapsed < bestTime) {
+            bestTime = elapsed;
+            profile = trial;
+        }
+    }
+}
+
+std::string trim(const std::string& text) {
+    const char* blanks = " \t\r";
+    std::size_t begin = text.find_first_not_of(blanks);
+    if (begin == std::string::npos) {
+        return "";
+    }
+    return text.substr(begin, text.find_last_not_of(blanks) - begin + 1);
+}
+
+int parseBlockSize(const std::string& key, const std::string& value) {
+    std::size_t used = 0;
+    int size = 0;
+    try {
+        size = std::stoi(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size() || size <= 0) {
+        throw std::invalid_argument("Invalid value for " + key + " in tuning profile: " + value);
+    }
+    return size;
+}
+
+// Apply the startup profile during static initialization of the library
+[[maybe_unused]] const bool STARTUP_PROFILE_APPLIED = loadStartupProfile();
+
+} // namespace
+
+TuningProfile currentProfile() {
+    return {blockSizes(), simd::activeIsa()};
+}
+
+void applyProfile(const TuningProfile& profile) {
+    // Validate both parts before changing either
+    if (profile.blocks.mc <= 0 || profile.blocks.kc <= 0 || profile.blocks.nc <= 0) {
+        throw std::invalid_argument("Block sizes must be positive");
+    }
+    simd::setActiveIsa(profile.isa);
+    setBlockSizes(profile.blocks);
+}
+
+TuningProfile autotune(int size, int repetitions) {
+    if (size < 1) {
+        throw std::invalid_argument("Autotune size must be positive");
+    }
+    if (repetitions < 1) {
+        throw std::invalid_argument("Autotune repetitions must be positive");
+    }
+
+    Workload workload(size, repetitions);
+    TuningProfile best = currentProfile();
+    ProfileRestorer restorer(best);
+    // Warm up the caches, the thread pool and the packing buffers
+    workload.time(best);
+    double bestTime = workload.time(best);
+
+    TuningProfile trial = best;
+    for (simd::Isa isa : ALL_ISAS) {
+        if (isa == best.isa || isa > simd::detectedIsa()) {
+            continue;
+        }
+        trial.isa = isa;
+        double elapsed = workload.time(trial);
+        if (elapsed < bestTime) {
+            bestTime = elapsed;
+            best = trial;
+        }
+    }
+
+    tuneDimension(workload, best, &BlockSizes::kc, KC_CANDIDATES, bestTime);
+    tuneDimension(workload, best, &BlockSizes::mc, MC_CANDIDATES, bestTime);
+    tuneDimension(workload, best, &BlockSizes::nc, NC_CANDIDATES, bestTime);
+
+    applyProfile(best);
+    restorer.dismiss();
+    return best;
+}
+
+void saveProfile(const TuningProfile& profile, const std::string& path) {
+    std::ofstream file(path);
+    file << "# SquareMat GEMM tuning profile\n"
+         << "isa = " << simd::isaName(profile.isa) << "\n"
+         << "mc = " << profile.blocks.mc << "\n"
+         << "kc = " << profile.blocks.kc << "\n"
+         << "nc = " << profile.blocks.nc << "\n";
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Cannot write tuning profile " + path);
+    }
+}
+
+TuningProfile loadProfile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot read tuning profile " + path);
+    }
+
+    TuningProfile profile = {{0, 0, 0}, simd::Isa::Scalar};
+    bool haveIsa = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("Malformed line in tuning profile: " + line);
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        if (key == "isa") {
+            auto match = std::find_if(std::begin(ALL_ISAS), std::end(ALL_ISAS),
+                                      [&](simd::Isa isa) { return value == simd::isaName(isa); });
+            if (match == std::end(ALL_ISAS)) {
+                throw std::invalid_argument("Unknown instruction set in tuning profile: " + value);
+            }
+            profile.isa = *match;
+            haveIsa = true;
+        } else if (key == "mc") {
+            profile.blocks.mc = parseBlockSize(key, value);
+        } else if (key == "kc") {
+            profile.blocks.kc = parseBlockSize(key, value);
+        } else if (key == "nc") {
+            profile.blocks.nc = parseBlockSize(key, value);
+        } else {
+            throw std::invalid_argument("Unknown key in tuning profile: " + key);
+        }
+    }
+    if (!haveIsa || profile.blocks.mc == 0 || profile.blocks.kc == 0 || profile.blocks.nc == 0) {
+        throw std::invalid_argument("Incomplete tuning profile " + path);
+    }
+    return profile;
+}
+
+bool loadStartupProfile() {
+    const char* path = std::getenv(PROFILE_VARIABLE);
+    if (path == nullptr || *path == '\0') {
+        return false;
+    }
+    try {
+        applyProfile(loadProfile(path));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace gemm
+} // namespace matrix_ops
@@ -0,0 +1,107 @@
+// idocohen963@gmail.com
+
+#include "../include/BufferPool.hpp"
+#include "../include/SquareMat.hpp"
+#include <memory_resource>
+
+namespace matrix_ops {
+
+namespace {
+// Lifecycle of the calling thread's pool. Trivially destructible, so it stays
+// readable after the pool itself has been destroyed during thread teardown.
+enum class PoolState { Unborn, Alive, Dead };
+thread_local PoolState poolState = PoolState::Unborn;
+}
+
+BufferPool& BufferPool::local() {
+    thread_local BufferPool pool;
+    return pool;
+}
+
+BufferPool* BufferPool::localIfAlive() {
+    return poolState == PoolState::Dead ? nullptr : &local();
+}
+
+BufferPool::BufferPool() {
+    poolState = PoolState::Alive;
+}
+
+BufferPool::~BufferPool() {
+    clear();
+    poolState = PoolState::Dead;
+}
+
+void* BufferPool::acquire(std::size_t bytes) {
+    if (isEnabled) {
+        auto it = freeLists.find(bytes);
+        if (it != freeLists.end() && !it->second.empty()) {
+            void* ptr = it->second.back();
+            it->second.pop_back();
+            totalBytes -= bytes;
+            ++counters.hits;
+            return ptr;
+        }
+    }
+    ++counters.misses;
+    return nullptr;
+}
+
+bool BufferPool::release(void* ptr, std::size_t bytes) {
+    if (!isEnabled || totalBytes + bytes > maxBytes) {
+        ++counters.drops;
+        return false;
+    }
+    std::vector<void*>& list = freeLists[bytes];
+    if (list.size() >= maxBuffersPerSize) {
+        ++counters.drops;
+        return false;
+    }
+    list.push_back(ptr);
+    totalBytes += bytes;
+    ++counters.returns;
+    return true;
+}
+
+void BufferPool::clear() {
+    for (auto& entry : freeLists) {
+        for (void* ptr : entry.second) {
+            free(ptr, entry.first);
+        }
+    }
+    freeLists.clear();
+    totalBytes = 0;
+}
+
+void BufferPool::setEnabled(bool enabled) {
+    isEnabled = enabled;
+    if (!enabled) {
+        clear();
+    }
+}
+
+void BufferPool::setMaxBuffersPerSize(std::size_t maxBuffers) {
+    maxBuffersPerSize = maxBuffers;
+    trim();
+}
+
+void BufferPool::setMaxBytes(std::size_t maxBytes) {
+    this->maxBytes = maxBytes;
+    trim();
+}
+
+void BufferPool::trim() {
+    for (auto& entry : freeLists) {
+        std::vector<void*>& list = entry.second;
+        while (!list.empty() && (list.size() > maxBuffersPerSize || totalBytes > maxBytes)) {
+            free(list.back(), entry.first);
+            list.pop_back();
+            totalBytes -= entry.first;
+        }
+    }
+}
+
+void BufferPool::free(void* ptr, std::size_t bytes) {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, SquareMat::ALIGNMENT);
+}
+
+} // namespace matrix_ops
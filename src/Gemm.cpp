@@ -0,0 +1,547 @@
+// idocohen963@gmail.com
+
+#include "../include/Gemm.hpp"
+#include "../include/Simd.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace matrix_ops {
+namespace gemm {
+
+namespace {
+
+std::mutex blockSizesMutex;  ///< Guards currentBlockSizes (three ints, too wide for a lock-free atomic)
+BlockSizes currentBlockSizes = DEFAULT_BLOCK_SIZES;
+std::atomic<int> currentThreadCount(ThreadPool::hardwareThreads());
+std::atomic<Algorithm> currentAlgorithm(Algorithm::Classical);
+std::atomic<int> currentStrassenCrossover(DEFAULT_STRASSEN_CROSSOVER);
+
+constexpr int MR = 4;                   ///< Rows of the portable micro-kernel tile
+constexpr int NR = 8;                   ///< Columns of the portable micro-kernel tile
+constexpr int MAX_TILE = 8 * 16;        ///< Largest mr x nr tile of any kernel (AVX-512)
+constexpr std::size_t PACK_ALIGNMENT = 64;
+
+/**
+ * @brief Per-thread, grow-only aligned buffer for packed panels
+ */
+struct PackBuffer {
+    void* ptr = nullptr;
+    std::size_t bytes = 0;
+
+    void* reserve(std::size_t needed) {
+        if (needed > bytes) {
+            release();
+            ptr = ::operator new(needed, std::align_val_t(PACK_ALIGNMENT));
+            bytes = needed;
+        }
+        return ptr;
+    }
+
+    void release() {
+        if (ptr != nullptr) {
+            ::operator delete(ptr, std::align_val_t(PACK_ALIGNMENT));
+            ptr = nullptr;
+            bytes = 0;
+        }
+    }
+
+    ~PackBuffer() { release(); }
+};
+
+// Buffers of the calling thread: slot 0 holds A blocks, slot 1 holds B panels,
+// slot 2 holds the Strassen-Winograd workspace
+template <typename T>
+T* packBuffer(int slot, std::size_t count) {
+    thread_local PackBuffer buffers[3];
+    return static_cast<T*>(buffers[slot].reserve(count * sizeof(T)));
+}
+
+// Copy an mc x kc block of A into mr-row panels, each stored k-major, zero-padding the last panel
+template <typename T>
+void packA(int mc, int kc, const T* a, int lda, int mr, T* packed) {
+    for (int ir = 0; ir < mc; ir += mr) {
+        int rows = std::min(mr, mc - ir);
+        for (int k = 0; k < kc; ++k) {
+            for (int i = 0; i < rows; ++i) {
+                packed[i] = a[(ir + i) * lda + k];
+            }
+            for (int i = rows; i < mr; ++i) {
+                packed[i] = T();
+            }
+            packed += mr;
+        }
+    }
+}
+
+// Copy a kc x nc panel of B into nr-column slivers, each stored k-major, zero-padding the last one
+template <typename T>
+void packB(int kc, int nc, const T* b, int ldb, int nr, T* packed) {
+    for (int jr = 0; jr < nc; jr += nr) {
+        int cols = std::min(nr, nc - jr);
+        for (int k = 0; k < kc; ++k) {
+            const T* src = b + k * ldb + jr;
+            for (int j = 0; j < cols; ++j) {
+                packed[j] = src[j];
+            }
+            for (int j = cols; j < nr; ++j) {
+                packed[j] = T();
+            }
+            packed += nr;
+        }
+    }
+}
+
+// Same layout as packB, for the panel of B = A^T whose columns are rows jc.. of A (a points to A(jc, pc))
+template <typename T>
+void packTransposedB(int kc, int nc, const T* a, int lda, int nr, T* packed) {
+    for (int jr = 0; jr < nc; jr += nr) {
+        int cols = std::min(nr, nc - jr);
+        for (int j = 0; j < cols; ++j) {
+            const T* src = a + (jr + j) * lda;
+            for (int k = 0; k < kc; ++k) {
+                packed[k * nr + j] = src[k];
+            }
+        }
+        for (int j = cols; j < nr; ++j) {
+            for (int k = 0; k < kc; ++k) {
+                packed[k * nr + j] = T();
+            }
+        }
+        packed += kc * nr;
+    }
+}
+
+// C[MR x NR] = alpha * Apanel * Bsliver + beta * C; C is not read when beta is zero
+template <typename T>
+void microKernel(int kc, const T* a, const T* b, T* c, int ldc, T alpha, T beta) {
+    T acc[MR][NR] = {};
+    for (int k = 0; k < kc; ++k) {
+        const T* ak = a + k * MR;
+        const T* bk = b + k * NR;
+        for (int i = 0; i < MR; ++i) {
+            for (int j = 0; j < NR; ++j) {
+                acc[i][j] += ak[i] * bk[j];
+            }
+        }
+    }
+    for (int i = 0; i < MR; ++i) {
+        T* ci = c + i * ldc;
+        for (int j = 0; j < NR; ++j) {
+            ci[j] = (beta == T()) ? alpha * acc[i][j] : alpha * acc[i][j] + beta * ci[j];
+        }
+    }
+}
+
+/**
+ * @brief Micro-kernel selected for an element type
+ *
+ * double uses the runtime-dispatched SIMD kernels; the other types use the
+ * portable template above.
+ */
+template <typename T>
+struct KernelInfo {
+    int mr;
+    int nr;
+    void (*compute)(int kc, const T* a, const T* b, T* c, int ldc, T alpha, T beta);
+};
+
+template <typename T>
+KernelInfo<T> selectKernel() {
+    if constexpr (std::is_same_v<T, double>) {
+        const simd::Kernels& kernels = simd::kernels();
+        return {kernels.mr, kernels.nr, kernels.gemm};
+    } else {
+        return {MR, NR, microKernel<T>};
+    }
+}
+
+// Tile at the right or bottom edge: run the kernel into a scratch tile and merge the valid part
+template <typename T>
+void edgeKernel(const KernelInfo<T>& kernel, int rows, int cols, int kc, const T* a, const T* b, T* c, int ldc,
+                T alpha, T beta) {
+    alignas(PACK_ALIGNMENT) T tile[MAX_TILE];
+    const int nr = kernel.nr;
+    kernel.compute(kc, a, b, tile, nr, alpha, T());
+    for (int i = 0; i < rows; ++i) {
+        T* ci = c + i * ldc;
+        for (int j = 0; j < cols; ++j) {
+            ci[j] = (beta == T()) ? tile[i * nr + j] : tile[i * nr + j] + beta * ci[j];
+        }
+    }
+}
+
+// Multiply a packed mc x kc block of A by packed slivers of B covering nc columns of C.
+// With lowerOnly, tiles lying entirely above the diagonal of C are skipped; offset is
+// the column of C at the block's left edge minus the row of C at its top edge
+template <typename T>
+void multiplyBlock(const KernelInfo<T>& kernel, int mc, int nc, int kc, const T* packedA, const T* packedB,
+                   T* c, int ldc, T alpha, T beta, bool lowerOnly = false, int offset = 0) {
+    const int mr = kernel.mr;
+    const int nr = kernel.nr;
+    for (int jr = 0; jr < nc; jr += nr) {
+        int cols = std::min(nr, nc - jr);
+        const T* sliver = packedB + jr * kc;
+        for (int ir = 0; ir < mc; ir += mr) {
+            int rows = std::min(mr, mc - ir);
+            if (lowerOnly && offset + jr > ir + rows - 1) {
+                continue;
+            }
+            const T* panel = packedA + ir * kc;
+            T* tile = c + ir * ldc + jr;
+            if (rows == mr && cols == nr) {
+                kernel.compute(kc, panel, sliver, tile, ldc, alpha, beta);
+            } else {
+                edgeKernel(kernel, rows, cols, kc, panel, sliver, tile, ldc, alpha, beta);
+            }
+        }
+    }
+}
+
+int ceilDiv(int a, int b) {
+    return (a + b - 1) / b;
+}
+
+// R = X + Y for h x h blocks
+template <typename T>
+void addBlocks(int h, const T* x, int ldx, const T* y, int ldy, T* r, int ldr) {
+    for (int i = 0; i < h; ++i) {
+        for (int j = 0; j < h; ++j) {
+            r[i * ldr + j] = x[i * ldx + j] + y[i * ldy + j];
+        }
+    }
+}
+
+// R = X - Y for h x h blocks
+template <typename T>
+void subtractBlocks(int h, const T* x, int ldx, const T* y, int ldy, T* r, int ldr) {
+    for (int i = 0; i < h; ++i) {
+        for (int j = 0; j < h; ++j) {
+            r[i * ldr + j] = x[i * ldx + j] - y[i * ldy + j];
+        }
+    }
+}
+
+// Elements of workspace needed by the recursion for size n: two half-size blocks per level
+std::size_t strassenWorkspace(int n, int crossover) {
+    std::size_t total = 0;
+    while (n > crossover) {
+        int h = n / 2;
+        total += 2 * static_cast<std::size_t>(h) * h;
+        n = h;
+    }
+    return total;
+}
+
+/**
+ * @brief One level of the Strassen-Winograd recursion, C = A * B
+ *
+ * Uses the schedule of Boyer, Dumas, Pernet and Zhou (ISSAC 2009) with two
+ * temporaries: X holds the A-side sums and later P1, Y holds the B-side sums,
+ * and the quadrants of C hold the remaining products.
+ */
+template <typename T>
+void strassen(int n, const T* a, int lda, const T* b, int ldb, T* c, int ldc, T* work, int crossover,
+              int threads) {
+    if (n <= crossover) {
+        multiply(n, T(1), a, lda, b, ldb, T(), c, ldc, threads);
+        return;
+    }
+
+    const int m = n & ~1;  // Even part; an odd last row and column are peeled off
+    const int h = m / 2;
+    const T* a11 = a;
+    const T* a12 = a + h;
+    const T* a21 = a + h * lda;
+    const T* a22 = a21 + h;
+    const T* b11 = b;
+    const T* b12 = b + h;
+    const T* b21 = b + h * ldb;
+    const T* b22 = b21 + h;
+    T* c11 = c;
+    T* c12 = c + h;
+    T* c21 = c + h * ldc;
+    T* c22 = c21 + h;
+    T* x = work;
+    T* y = work + static_cast<std::size_t>(h) * h;
+    T* next = y + static_cast<std::size_t>(h) * h;
+
+    subtractBlocks(h, a11, lda, a21, lda, x, h);                    // S3 = A11 - A21
+    subtractBlocks(h, b22, ldb, b12, ldb, y, h);                    // T3 = B22 - B12
+    strassen(h, x, h, y, h, c21, ldc, next, crossover, threads);    // P7 = S3 T3
+    addBlocks(h, a21, lda, a22, lda, x, h);                         // S1 = A21 + A22
+    subtractBlocks(h, b12, ldb, b11, ldb, y, h);                    // T1 = B12 - B11
+    strassen(h, x, h, y, h, c22, ldc, next, crossover, threads);    // P5 = S1 T1
+    subtractBlocks(h, x, h, a11, lda, x, h);                        // S2 = S1 - A11
+    subtractBlocks(h, b22, ldb, y, h, y, h);                        // T2 = B22 - T1
+    strassen(h, x, h, y, h, c12, ldc, next, crossover, threads);    // P6 = S2 T2
+    subtractBlocks(h, a12, lda, x, h, x, h);                        // S4 = A12 - S2
+    strassen(h, x, h, b22, ldb, c11, ldc, next, crossover, threads);  // P3 = S4 B22
+    strassen(h, a11, lda, b11, ldb, x, h, next, crossover, threads);  // P1 = A11 B11
+    addBlocks(h, x, h, c12, ldc, c12, ldc);                         // U2 = P1 + P6
+    addBlocks(h, c12, ldc, c21, ldc, c21, ldc);                     // U3 = U2 + P7
+    addBlocks(h, c12, ldc, c22, ldc, c12, ldc);                     // U4 = U2 + P5
+    addBlocks(h, c21, ldc, c22, ldc, c22, ldc);                     // U7 = U3 + P5 = C22
+    addBlocks(h, c12, ldc, c11, ldc, c12, ldc);                     // U5 = U4 + P3 = C12
+    subtractBlocks(h, y, h, b21, ldb, y, h);                        // T4 = T2 - B21
+    strassen(h, a22, lda, y, h, c11, ldc, next, crossover, threads);  // P4 = A22 T4
+    subtractBlocks(h, c21, ldc, c11, ldc, c21, ldc);                // U6 = U3 - P4 = C21
+    strassen(h, a12, lda, b21, ldb, c11, ldc, next, crossover, threads);  // P2 = A12 B21
+    addBlocks(h, x, h, c11, ldc, c11, ldc);                         // U1 = P1 + P2 = C11
+
+    if (m == n) {
+        return;
+    }
+    // Peeling: the leading block gets the rank-1 term of the last column of A and
+    // last row of B; the last column and row of C are formed directly
+    const T* aLast = a + m;
+    const T* bLast = b + m * ldb;
+    for (int i = 0; i < m; ++i) {
+        T aim = aLast[i * lda];
+        T* ci = c + i * ldc;
+        for (int j = 0; j < m; ++j) {
+            ci[j] += aim * bLast[j];
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        T sum = T();
+        for (int k = 0; k < n; ++k) {
+            sum += a[i * lda + k] * b[k * ldb + m];
+        }
+        c[i * ldc + m] = sum;
+    }
+    const T* am = a + m * lda;
+    T* cm = c + m * ldc;
+    for (int j = 0; j < m; ++j) {
+        cm[j] = T();
+    }
+    for (int k = 0; k < n; ++k) {
+        T amk = am[k];
+        const T* bk = b + k * ldb;
+        for (int j = 0; j < m; ++j) {
+            cm[j] += amk * bk[j];
+        }
+    }
+}
+
+// Direct i-k-j product for small sizes, where packing would cost more than it saves
+template <typename T>
+void multiplySmall(int n, T alpha, const T* a, int lda, const T* b, int ldb, T beta, T* c, int ldc) {
+    for (int i = 0; i < n; ++i) {
+        T* ci = c + i * ldc;
+        for (int j = 0; j < n; ++j) {
+            ci[j] = (beta == T()) ? T() : beta * ci[j];
+        }
+        for (int k = 0; k < n; ++k) {
+            T aik = alpha * a[i * lda + k];
+            const T* bk = b + k * ldb;
+            for (int j = 0; j < n; ++j) {
+                ci[j] += aik * bk[j];
+            }
+        }
+    }
+}
+
+// Lower triangle of C = alpha * A * A^T + beta * C for small sizes: dot products of row pairs
+template <typename T>
+void gramSmall(int n, T alpha, const T* a, int lda, T beta, T* c, int ldc) {
+    for (int i = 0; i < n; ++i) {
+        const T* ai = a + i * lda;
+        T* ci = c + i * ldc;
+        for (int j = 0; j <= i; ++j) {
+            const T* aj = a + j * lda;
+            T sum = T();
+            for (int k = 0; k < n; ++k) {
+                sum += ai[k] * aj[k];
+            }
+            ci[j] = (beta == T()) ? alpha * sum : alpha * sum + beta * ci[j];
+        }
+    }
+}
+
+// Copy the strict lower triangle of C onto the upper one, in tiles so both sides stay cached
+template <typename T>
+void mirrorLower(int n, T* c, int ldc) {
+    constexpr int TILE = 32;
+    for (int ib = 0; ib < n; ib += TILE) {
+        for (int jb = ib; jb < n; jb += TILE) {
+            for (int i = ib; i < std::min(ib + TILE, n); ++i) {
+                for (int j = std::max(jb, i + 1); j < std::min(jb + TILE, n); ++j) {
+                    c[i * ldc + j] = c[j * ldc + i];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief The blocked, parallel engine behind multiply() and gram()
+ *
+ * With gram set, B is A^T: its panels are packed straight from the rows of A,
+ * and only the tiles of C touching the lower triangle are computed.
+ */
+template <typename T>
+void blockedProduct(int n, T alpha, const T* a, int lda, const T* b, int ldb, T beta, T* c, int ldc, int threads,
+                    bool gram) {
+    if (threads <= 0) {
+        threads = threadCount();
+    }
+    if (n < PARALLEL_PRODUCT_LIMIT) {
+        threads = 1;
+    }
+
+    const KernelInfo<T> kernel = selectKernel<T>();
+    const int mr = kernel.mr;
+    const int nr = kernel.nr;
+    const BlockSizes blocks = blockSizes();
+    const int kcMax = std::min(blocks.kc, n);
+    const int ncMax = std::min(blocks.nc, n);
+    // Shrink the row blocks until every thread gets one, and split the column
+    // panel as well when there are more threads than row blocks
+    int mcMax = std::min(blocks.mc, n);
+    if (threads > 1) {
+        mcMax = std::min(mcMax, ceilDiv(ceilDiv(n, threads), mr) * mr);
+    }
+    const int rowTasks = ceilDiv(n, mcMax);
+    const int colSplit = std::max(1, ceilDiv(threads, rowTasks));
+    const std::size_t packedASize = static_cast<std::size_t>(ceilDiv(mcMax, mr) * mr) * kcMax;
+    T* packedB = packBuffer<T>(1, static_cast<std::size_t>(ceilDiv(ncMax, nr) * nr) * kcMax);
+    ThreadPool& pool = ThreadPool::instance();
+
+    for (int jc = 0; jc < n; jc += ncMax) {
+        int nc = std::min(ncMax, n - jc);
+        // Column chunks are whole slivers, so each one starts at a sliver boundary of packedB
+        const int colChunk = ceilDiv(ceilDiv(nc, colSplit), nr) * nr;
+        const int colTasks = ceilDiv(nc, colChunk);
+        for (int pc = 0; pc < n; pc += kcMax) {
+            int kc = std::min(kcMax, n - pc);
+            // Only the first depth block applies beta; later ones accumulate
+            T betaBlock = (pc == 0) ? beta : T(1);
+
+            pool.parallelFor(colTasks, threads, [&](int task) {
+                int jr = task * colChunk;
+                int width = std::min(colChunk, nc - jr);
+                if (gram) {
+                    packTransposedB(kc, width, a + (jc + jr) * lda + pc, lda, nr, packedB + jr * kc);
+                } else {
+                    packB(kc, width, b + pc * ldb + jc + jr, ldb, nr, packedB + jr * kc);
+                }
+            });
+
+            pool.parallelFor(rowTasks * colTasks, threads, [&](int task) {
+                int ic = (task / colTasks) * mcMax;
+                int jr = (task % colTasks) * colChunk;
+                int mc = std::min(mcMax, n - ic);
+                if (gram && jc + jr > ic + mc - 1) {
+                    return;  // The whole block lies above the diagonal
+                }
+                // Each thread packs A into its own buffer
+                T* packedA = packBuffer<T>(0, packedASize);
+                packA(mc, kc, a + ic * lda + pc, lda, mr, packedA);
+                multiplyBlock(kernel, mc, std::min(colChunk, nc - jr), kc, packedA, packedB + jr * kc,
+                              c + ic * ldc + jc + jr, ldc, alpha, betaBlock, gram, jc + jr - ic);
+            });
+        }
+    }
+}
+
+} // namespace
+
+BlockSizes blockSizes() {
+    std::lock_guard<std::mutex> lock(blockSizesMutex);
+    return currentBlockSizes;
+}
+
+void setBlockSizes(BlockSizes sizes) {
+    if (sizes.mc <= 0 || sizes.kc <= 0 || sizes.nc <= 0) {
+        throw std::invalid_argument("Block sizes must be positive");
+    }
+    std::lock_guard<std::mutex> lock(blockSizesMutex);
+    currentBlockSizes = sizes;
+}
+
+int threadCount() {
+    return currentThreadCount.load(std::memory_order_relaxed);
+}
+
+void setThreadCount(int threads) {
+    if (threads < 1) {
+        throw std::invalid_argument("Thread count must be positive");
+    }
+    currentThreadCount.store(threads, std::memory_order_relaxed);
+}
+
+template <typename T>
+void multiply(int n, T alpha, const T* a, int lda, const T* b, int ldb, T beta, T* c, int ldc, int threads) {
+    if (n <= SMALL_PRODUCT_LIMIT) {
+        multiplySmall(n, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    blockedProduct(n, alpha, a, lda, b, ldb, beta, c, ldc, threads, false);
+}
+
+template <typename T>
+void gram(int n, T alpha, const T* a, int lda, T beta, T* c, int ldc, int threads) {
+    if (n <= SMALL_PRODUCT_LIMIT) {
+        gramSmall(n, alpha, a, lda, beta, c, ldc);
+    } else {
+        blockedProduct(n, alpha, a, lda, a, lda, beta, c, ldc, threads, true);
+    }
+    mirrorLower(n, c, ldc);
+}
+
+Algorithm algorithm() {
+    return currentAlgorithm.load(std::memory_order_relaxed);
+}
+
+void setAlgorithm(Algorithm algorithm) {
+    currentAlgorithm.store(algorithm, std::memory_order_relaxed);
+}
+
+int strassenCrossover() {
+    return currentStrassenCrossover.load(std::memory_order_relaxed);
+}
+
+void setStrassenCrossover(int size) {
+    if (size < 1) {
+        throw std::invalid_argument("Strassen crossover must be positive");
+    }
+    currentStrassenCrossover.store(size, std::memory_order_relaxed);
+}
+
+template <typename T>
+void multiplyStrassen(int n, const T* a, int lda, const T* b, int ldb, T* c, int ldc, int threads) {
+    const int crossover = strassenCrossover();
+    T* work = packBuffer<T>(2, strassenWorkspace(n, crossover));
+    strassen(n, a, lda, b, ldb, c, ldc, work, crossover, threads);
+}
+
+// Explicit instantiations for the supported element types
+
+template void multiply<float>(int, float, const float*, int, const float*, int, float, float*, int, int);
+template void multiply<double>(int, double, const double*, int, const double*, int, double, double*, int, int);
+template void multiply<std::int32_t>(int, std::int32_t, const std::int32_t*, int, const std::int32_t*, int,
+                                     std::int32_t, std::int32_t*, int, int);
+template void multiply<std::int64_t>(int, std::int64_t, const std::int64_t*, int, const std::int64_t*, int,
+                                     std::int64_t, std::int64_t*, int, int);
+
+template void gram<float>(int, float, const float*, int, float, float*, int, int);
+template void gram<double>(int, double, const double*, int, double, double*, int, int);
+template void gram<std::int32_t>(int, std::int32_t, const std::int32_t*, int, std::int32_t, std::int32_t*, int, int);
+template void gram<std::int64_t>(int, std::int64_t, const std::int64_t*, int, std::int64_t, std::int64_t*, int, int);
+
+template void multiplyStrassen<float>(int, const float*, int, const float*, int, float*, int, int);
+template void multiplyStrassen<double>(int, const double*, int, const double*, int, double*, int, int);
+template void multiplyStrassen<std::int32_t>(int, const std::int32_t*, int, const std::int32_t*, int,
+                                             std::int32_t*, int, int);
+template void multiplyStrassen<std::int64_t>(int, const std::int64_t*, int, const std::int64_t*, int,
+                                             std::int64_t*, int, int);
+
+} // namespace gemm
+} // namespace matrix_ops
@@ -0,0 +1,197 @@
+// idocohen963@gmail.com
+
+#include "../include/Gemv.hpp"
+#include "../include/Gemm.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace matrix_ops {
+namespace gemv {
+
+namespace {
+
+constexpr int ROWS_PER_PASS = 4;  ///< Matrix rows streamed together, sharing each load of the vector
+
+int resolveThreads(int threads, long long work, long long limit) {
+    if (work < limit) {
+        return 1;
+    }
+    return (threads > 0) ? threads : gemm::threadCount();
+}
+
+// Split [0, n) into one contiguous range per thread, aligned to ROWS_PER_PASS
+struct Partition {
+    int chunk;
+    int tasks;
+
+    Partition(int n, int threads) {
+        chunk = (n + threads - 1) / threads;
+        chunk = (chunk + ROWS_PER_PASS - 1) / ROWS_PER_PASS * ROWS_PER_PASS;
+        tasks = (n + chunk - 1) / chunk;
+    }
+};
+
+// y[rows] = alpha * A[rows] * x + beta * y[rows]
+template <typename T>
+void multiplyRows(int begin, int end, int n, T alpha, const T* a, int lda, const T* x, T beta, T* y) {
+    int i = begin;
+    for (; i + ROWS_PER_PASS <= end; i += ROWS_PER_PASS) {
+        const T* a0 = a + i * lda;
+        const T* a1 = a0 + lda;
+        const T* a2 = a1 + lda;
+        const T* a3 = a2 + lda;
+        T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+        for (int j = 0; j < n; ++j) {
+            T xj = x[j];
+            s0 += a0[j] * xj;
+            s1 += a1[j] * xj;
+            s2 += a2[j] * xj;
+            s3 += a3[j] * xj;
+        }
+        T sums[ROWS_PER_PASS] = {s0, s1, s2, s3};
+        for (int r = 0; r < ROWS_PER_PASS; ++r) {
+            y[i + r] = (beta == T()) ? alpha * sums[r] : alpha * sums[r] + beta * y[i + r];
+        }
+    }
+    for (; i < end; ++i) {
+        const T* ai = a + i * lda;
+        T sum = T();
+        for (int j = 0; j < n; ++j) {
+            sum += ai[j] * x[j];
+        }
+        y[i] = (beta == T()) ? alpha * sum : alpha * sum + beta * y[i];
+    }
+}
+
+// acc[0, width) += x[rows] * A[rows][0, width), four rows per pass over acc
+template <typename T>
+void accumulateRows(int rowBegin, int rowEnd, int width, const T* a, int lda, const T* x, T* acc) {
+    int i = rowBegin;
+    for (; i + ROWS_PER_PASS <= rowEnd; i += ROWS_PER_PASS) {
+        const T* a0 = a + i * lda;
+        const T* a1 = a0 + lda;
+        const T* a2 = a1 + lda;
+        const T* a3 = a2 + lda;
+        T x0 = x[i], x1 = x[i + 1], x2 = x[i + 2], x3 = x[i + 3];
+        for (int j = 0; j < width; ++j) {
+            acc[j] += x0 * a0[j] + x1 * a1[j] + x2 * a2[j] + x3 * a3[j];
+        }
+    }
+    for (; i < rowEnd; ++i) {
+        const T* ai = a + i * lda;
+        T xi = x[i];
+        for (int j = 0; j < width; ++j) {
+            acc[j] += xi * ai[j];
+        }
+    }
+}
+
+// Dot product with independent partial sums, so the loop is not one long dependency chain
+template <typename T>
+T dotRange(int begin, int end, const T* x, const T* y) {
+    T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < end; ++i) {
+        s0 += x[i] * y[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+} // namespace
+
+template <typename T>
+void multiply(int n, T alpha, const T* a, int lda, const T* x, T beta, T* y, int threads) {
+    threads = resolveThreads(threads, n, PARALLEL_PRODUCT_LIMIT);
+    // Each thread owns a contiguous band of rows, and thus of y
+    Partition bands(n, threads);
+    ThreadPool::instance().parallelFor(bands.tasks, threads, [&](int task) {
+        int begin = task * bands.chunk;
+        multiplyRows(begin, std::min(n, begin + bands.chunk), n, alpha, a, lda, x, beta, y);
+    });
+}
+
+template <typename T>
+void multiplyTransposed(int n, T alpha, const T* a, int lda, const T* x, T beta, T* y, int threads) {
+    threads = resolveThreads(threads, n, PARALLEL_PRODUCT_LIMIT);
+    // Each thread owns a band of columns (of y) and streams that part of every row
+    Partition bands(n, threads);
+    ThreadPool::instance().parallelFor(bands.tasks, threads, [&](int task) {
+        int begin = task * bands.chunk;
+        int end = std::min(n, begin + bands.chunk);
+        std::vector<T> acc(end - begin);
+        accumulateRows(0, n, end - begin, a + begin, lda, x, acc.data());
+        for (int j = begin; j < end; ++j) {
+            T sum = acc[j - begin];
+            y[j] = (beta == T()) ? alpha * sum : alpha * sum + beta * y[j];
+        }
+    });
+}
+
+template <typename T>
+T dot(int n, const T* x, const T* y, int threads) {
+    threads = resolveThreads(threads, n, PARALLEL_LENGTH_LIMIT);
+    if (threads == 1) {
+        return dotRange(0, n, x, y);
+    }
+    Partition chunks(n, threads);
+    std::vector<T> partial(chunks.tasks);
+    ThreadPool::instance().parallelFor(chunks.tasks, threads, [&](int task) {
+        int begin = task * chunks.chunk;
+        partial[task] = dotRange(begin, std::min(n, begin + chunks.chunk), x, y);
+    });
+    T sum = T();
+    for (T p : partial) {
+        sum += p;
+    }
+    return sum;
+}
+
+template <typename T>
+void axpy(int n, T alpha, const T* x, T* y, int threads) {
+    threads = resolveThreads(threads, n, PARALLEL_LENGTH_LIMIT);
+    Partition chunks(n, threads);
+    ThreadPool::instance().parallelFor(chunks.tasks, threads, [&](int task) {
+        int begin = task * chunks.chunk;
+        int end = std::min(n, begin + chunks.chunk);
+        for (int i = begin; i < end; ++i) {
+            y[i] += alpha * x[i];
+        }
+    });
+}
+
+// Explicit instantiations for the supported element types
+
+template void multiply<float>(int, float, const float*, int, const float*, float, float*, int);
+template void multiply<double>(int, double, const double*, int, const double*, double, double*, int);
+template void multiply<std::int32_t>(int, std::int32_t, const std::int32_t*, int, const std::int32_t*,
+                                     std::int32_t, std::int32_t*, int);
+template void multiply<std::int64_t>(int, std::int64_t, const std::int64_t*, int, const std::int64_t*,
+                                     std::int64_t, std::int64_t*, int);
+
+template void multiplyTransposed<float>(int, float, const float*, int, const float*, float, float*, int);
+template void multiplyTransposed<double>(int, double, const double*, int, const double*, double, double*, int);
+template void multiplyTransposed<std::int32_t>(int, std::int32_t, const std::int32_t*, int, const std::int32_t*,
+                                               std::int32_t, std::int32_t*, int);
+template void multiplyTransposed<std::int64_t>(int, std::int64_t, const std::int64_t*, int, const std::int64_t*,
+                                               std::int64_t, std::int64_t*, int);
+
+template float dot<float>(int, const float*, const float*, int);
+template double dot<double>(int, const double*, const double*, int);
+template std::int32_t dot<std::int32_t>(int, const std::int32_t*, const std::int32_t*, int);
+template std::int64_t dot<std::int64_t>(int, const std::int64_t*, const std::int64_t*, int);
+
+template void axpy<float>(int, float, const float*, float*, int);
+template void axpy<double>(int, double, const double*, double*, int);
+template void axpy<std::int32_t>(int, std::int32_t, const std::int32_t*, std::int32_t*, int);
+template void axpy<std::int64_t>(int, std::int64_t, const std::int64_t*, std::int64_t*, int);
+
+} // namespace gemv
+} // namespace matrix_ops
@@ -0,0 +1,272 @@
+// idocohen963@gmail.com
+
+#include "../include/Modular.hpp"
+#include "../include/Gemm.hpp"
+#include "../include/Simd.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace matrix_ops {
+
+namespace {
+
+__extension__ typedef unsigned __int128 uint128;
+
+constexpr std::uint64_t NARROW_LIMIT = std::uint64_t(1) << 32;  ///< Largest modulus whose residues fit in 32 bits
+
+/**
+ * @brief Barrett reduction of an accumulator modulo a fixed m
+ *
+ * With mu = floor((2^w - 1) / m), the estimate q = floor(x * mu / 2^w) is at
+ * most 2 below floor(x / m), so x - q * m needs at most two corrections.
+ */
+template <typename Acc>
+struct Barrett;
+
+template <>
+struct Barrett<std::uint64_t> {
+    std::uint64_t m;
+    std::uint64_t mu;
+
+    explicit Barrett(std::uint64_t m) : m(m), mu(~std::uint64_t(0) / m) {}
+
+    std::uint64_t reduce(std::uint64_t x) const {
+        std::uint64_t q = static_cast<std::uint64_t>((static_cast<uint128>(x) * mu) >> 64);
+        std::uint64_t r = x - q * m;
+        r = (r >= m) ? r - m : r;
+        return (r >= m) ? r - m : r;
+    }
+};
+
+template <>
+struct Barrett<uint128> {
+    std::uint64_t m;
+    uint128 mu;
+
+    explicit Barrett(std::uint64_t m) : m(m), mu(~uint128(0) / m) {}
+
+    // High 128 bits of the 256-bit product x * mu, from four 64 x 64 -> 128-bit products
+    uint128 multiplyHigh(uint128 x) const {
+        std::uint64_t x0 = static_cast<std::uint64_t>(x);
+        std::uint64_t x1 = static_cast<std::uint64_t>(x >> 64);
+        std::uint64_t u0 = static_cast<std::uint64_t>(mu);
+        std::uint64_t u1 = static_cast<std::uint64_t>(mu >> 64);
+        uint128 p00 = static_cast<uint128>(x0) * u0;
+        uint128 p01 = static_cast<uint128>(x0) * u1;
+        uint128 p10 = static_cast<uint128>(x1) * u0;
+        uint128 p11 = static_cast<uint128>(x1) * u1;
+        uint128 middle = (p00 >> 64) + static_cast<std::uint64_t>(p01) + static_cast<std::uint64_t>(p10);
+        return p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+    }
+
+    uint128 reduce(uint128 x) const {
+        uint128 r = x - multiplyHigh(x) * m;
+        r = (r >= m) ? r - m : r;
+        return (r >= m) ? r - m : r;
+    }
+};
+
+/**
+ * @brief Dense n x n matrices of residues modulo m, multiplied with lazy reduction
+ *
+ * @tparam Elem Residue type (std::uint32_t when m <= 2^32, else std::uint64_t)
+ * @tparam Acc Accumulator type, wide enough for one product plus a residue
+ */
+template <typename Elem, typename Acc>
+class ModularRing {
+private:
+    int n;
+    Barrett<Acc> reducer;
+    int chunk;    ///< Products that can be accumulated onto a residue without overflow
+    int threads;
+
+    // acc[0, n) += aik * bk[0, n); residues below 2^32 use the widening SIMD kernel
+    void multiplyAddRow(Acc aik, const Elem* bk, Acc* acc) const {
+        if constexpr (std::is_same<Elem, std::uint32_t>::value) {
+            simd::kernels().multiplyAddWide(aik, bk, acc, n);
+        } else {
+            for (int j = 0; j < n; ++j) {
+                acc[j] += aik * bk[j];
+            }
+        }
+    }
+
+    // acc = A[rows] * B, reducing every chunk terms, written to C[rows]
+    void multiplyRows(int begin, int end, const Elem* a, const Elem* b, Elem* c, Acc* acc) const {
+        for (int i = begin; i < end; ++i) {
+            std::fill(acc, acc + n, Acc());
+            for (int k0 = 0; k0 < n; k0 += chunk) {
+                int kEnd = std::min(n, k0 + chunk);
+                for (int k = k0; k < kEnd; ++k) {
+                    multiplyAddRow(a[i * n + k], b + k * n, acc);
+                }
+                for (int j = 0; j < n; ++j) {
+                    acc[j] = reducer.reduce(acc[j]);
+                }
+            }
+            for (int j = 0; j < n; ++j) {
+                c[i * n + j] = static_cast<Elem>(acc[j]);
+            }
+        }
+    }
+
+public:
+    ModularRing(int n, std::uint64_t m, int threads) : n(n), reducer(m), chunk(n), threads(threads) {
+        if (m > 1) {
+            // Keep residue + chunk * (m - 1)^2 within the accumulator
+            uint128 square = static_cast<uint128>(m - 1) * (m - 1);
+            uint128 room = (static_cast<uint128>(std::numeric_limits<Acc>::max()) - (m - 1)) / square;
+            chunk = static_cast<int>(std::min<uint128>(room, static_cast<uint128>(n)));
+        }
+    }
+
+    template <typename T>
+    std::vector<Elem> load(const BasicSquareMat<T>& mat) const {
+        const std::int64_t m = static_cast<std::int64_t>(reducer.m);
+        MatrixView<const T> source = mat.view();
+        std::vector<Elem> residues(static_cast<std::size_t>(n) * n);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                std::int64_t r = static_cast<std::int64_t>(source.row(i)[j]) % m;
+                residues[i * n + j] = static_cast<Elem>((r < 0) ? r + m : r);
+            }
+        }
+        return residues;
+    }
+
+    template <typename T>
+    BasicSquareMat<T> store(const std::vector<Elem>& residues, std::pmr::memory_resource* resource) const {
+        BasicSquareMat<T> result(n, resource);
+        MatrixView<T> target = result.view();
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                target.row(i)[j] = static_cast<T>(residues[i * n + j]);
+            }
+        }
+        return result;
+    }
+
+    // C = A * B mod m; C must not overlap A or B
+    void multiply(const Elem* a, const Elem* b, Elem* c) const {
+        const int bandSize = (n + threads - 1) / threads;
+        const int bands = (n + bandSize - 1) / bandSize;
+        ThreadPool::instance().parallelFor(bands, threads, [&](int band) {
+            std::vector<Acc> acc(n);
+            int begin = band * bandSize;
+            multiplyRows(begin, std::min(n, begin + bandSize), a, b, c, acc.data());
+        });
+    }
+
+    // base^exponent mod m by binary exponentiation, ping-ponging with one scratch matrix
+    std::vector<Elem> power(std::vector<Elem> base, std::uint64_t exponent) const {
+        std::vector<Elem> result(base.size(), Elem());
+        std::vector<Elem> scratch(base.size());
+        if (exponent == 0) {
+            for (int i = 0; i < n; ++i) {
+                result[i * n + i] = static_cast<Elem>(reducer.reduce(Acc(1)));
+            }
+            return result;
+        }
+        bool started = false;
+        while (true) {
+            if (exponent & 1) {
+                if (started) {
+                    multiply(result.data(), base.data(), scratch.data());
+                    std::swap(result, scratch);
+                } else {
+                    result = base;
+                    started = true;
+                }
+            }
+            exponent >>= 1;
+            if (exponent == 0) {
+                return result;
+            }
+            multiply(base.data(), base.data(), scratch.data());
+            std::swap(base, scratch);
+        }
+    }
+};
+
+template <typename T>
+void validate(std::int64_t modulus, int threads) {
+    if (modulus <= 0) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    if (modulus - 1 > std::numeric_limits<T>::max()) {
+        throw std::invalid_argument("Modulus is too large for the element type");
+    }
+    if (threads < 0) {
+        throw std::invalid_argument("Thread count cannot be negative");
+    }
+}
+
+int resolveThreads(int n, int threads) {
+    if (n < gemm::PARALLEL_PRODUCT_LIMIT) {
+        return 1;
+    }
+    return (threads > 0) ? threads : gemm::threadCount();
+}
+
+template <typename Elem, typename Acc, typename T>
+BasicSquareMat<T> multiplyIn(const BasicSquareMat<T>& a, const BasicSquareMat<T>& b, std::uint64_t m, int threads) {
+    int n = a.dimension();
+    ModularRing<Elem, Acc> ring(n, m, resolveThreads(n, threads));
+    std::vector<Elem> x = ring.load(a);
+    std::vector<Elem> y = ring.load(b);
+    std::vector<Elem> product(x.size());
+    ring.multiply(x.data(), y.data(), product.data());
+    return ring.template store<T>(product, a.memoryResource());
+}
+
+template <typename Elem, typename Acc, typename T>
+BasicSquareMat<T> powerIn(const BasicSquareMat<T>& a, std::uint64_t power, std::uint64_t m, int threads) {
+    int n = a.dimension();
+    ModularRing<Elem, Acc> ring(n, m, resolveThreads(n, threads));
+    return ring.template store<T>(ring.power(ring.load(a), power), a.memoryResource());
+}
+
+} // namespace
+
+template <typename T>
+BasicSquareMat<T> multiplyMod(const BasicSquareMat<T>& a, const BasicSquareMat<T>& b, std::int64_t modulus,
+                              int threads) {
+    validate<T>(modulus, threads);
+    if (a.dimension() != b.dimension()) {
+        throw std::invalid_argument("Matrix sizes do not match for modular multiplication");
+    }
+
+    std::uint64_t m = static_cast<std::uint64_t>(modulus);
+    if (m <= NARROW_LIMIT) {
+        return multiplyIn<std::uint32_t, std::uint64_t>(a, b, m, threads);
+    }
+    return multiplyIn<std::uint64_t, uint128>(a, b, m, threads);
+}
+
+template <typename T>
+BasicSquareMat<T> powmod(const BasicSquareMat<T>& a, std::uint64_t power, std::int64_t modulus, int threads) {
+    validate<T>(modulus, threads);
+
+    std::uint64_t m = static_cast<std::uint64_t>(modulus);
+    if (m <= NARROW_LIMIT) {
+        return powerIn<std::uint32_t, std::uint64_t>(a, power, m, threads);
+    }
+    return powerIn<std::uint64_t, uint128>(a, power, m, threads);
+}
+
+// Explicit instantiations for the integer element types
+
+template BasicSquareMat<std::int32_t> multiplyMod(const BasicSquareMat<std::int32_t>&,
+                                                  const BasicSquareMat<std::int32_t>&, std::int64_t, int);
+template BasicSquareMat<std::int64_t> multiplyMod(const BasicSquareMat<std::int64_t>&,
+                                                  const BasicSquareMat<std::int64_t>&, std::int64_t, int);
+
+template BasicSquareMat<std::int32_t> powmod(const BasicSquareMat<std::int32_t>&, std::uint64_t, std::int64_t, int);
+template BasicSquareMat<std::int64_t> powmod(const BasicSquareMat<std::int64_t>&, std::uint64_t, std::int64_t, int);
+
+} // namespace matrix_ops
@@ -0,0 +1,165 @@
+// idocohen963@gmail.com
+
+#include "../include/PowerCache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace matrix_ops {
+
+namespace {
+
+// Bitwise, so a NaN element matches itself and does not drop the rungs on every query
+template <typename T>
+bool sameContents(MatrixView<const T> a, MatrixView<const T> b) {
+    if (a.dimension() != b.dimension()) {
+        return false;
+    }
+    for (int i = 0; i < a.dimension(); ++i) {
+        if (std::memcmp(a.row(i), b.row(i), a.dimension() * sizeof(T)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// Private helper methods
+
+template <typename T>
+std::size_t BasicPowerCache<T>::footprint(const BasicSquareMat<T>& mat) {
+    std::size_t bytes = sizeof(BasicSquareMat<T>);
+    if (mat.dimension() > BasicSquareMat<T>::INLINE_SIZE) {
+        bytes += static_cast<std::size_t>(mat.dimension()) * mat.leadingDimension() * sizeof(T);
+    }
+    return bytes;
+}
+
+template <typename T>
+void BasicPowerCache<T>::refresh() {
+    if (!sameContents(base.view(), std::as_const(snapshot).view())) {
+        clear();
+        snapshot = base;
+    }
+}
+
+template <typename T>
+void BasicPowerCache<T>::evictOne() {
+    int victim = 0;
+    for (int level = 1; level < static_cast<int>(ladder.size()); ++level) {
+        if (ladder[level] != nullptr && (victim == 0 || lastUse[level] < lastUse[victim])) {
+            victim = level;
+        }
+    }
+    if (victim != 0) {
+        used -= footprint(*ladder[victim]);
+        ladder[victim].reset();
+    }
+}
+
+template <typename T>
+void BasicPowerCache<T>::store(int level, const Rung& rung) {
+    std::size_t bytes = footprint(*rung);
+    if (bytes > capacity) {
+        return;
+    }
+    while (used + bytes > capacity) {
+        evictOne();
+    }
+    if (level >= static_cast<int>(ladder.size())) {
+        ladder.resize(level + 1);
+        lastUse.resize(level + 1);
+    }
+    ladder[level] = rung;
+    lastUse[level] = ++clock;
+    used += bytes;
+}
+
+template <typename T>
+typename BasicPowerCache<T>::Rung BasicPowerCache<T>::rung(int level) {
+    int start = std::min(level, static_cast<int>(ladder.size()) - 1);
+    while (start > 0 && ladder[start] == nullptr) {
+        --start;
+    }
+    // Level 0 is the snapshot of the base: a non-owning pointer, never stored
+    Rung current = (start == 0) ? Rung(Rung(), &snapshot) : ladder[start];
+    if (start > 0) {
+        lastUse[start] = ++clock;
+    }
+    for (int next = start + 1; next <= level; ++next) {
+        current = std::make_shared<const BasicSquareMat<T>>(*current * *current);
+        store(next, current);
+    }
+    return current;
+}
+
+// Constructor
+
+template <typename T>
+BasicPowerCache<T>::BasicPowerCache(const BasicSquareMat<T>& base, std::size_t capacity)
+    : base(base), snapshot(base), capacity(capacity), used(0), clock(0), ladder(1), lastUse(1) {}
+
+// Queries
+
+template <typename T>
+BasicSquareMat<T> BasicPowerCache<T>::power(int exponent) {
+    if (exponent < 0) {
+        throw std::invalid_argument("Negative powers are not supported");
+    }
+    if (base.dimension() == 0) {
+        throw std::length_error("Cannot take powers of an empty matrix");
+    }
+    refresh();
+    if (exponent == 0) {
+        return BasicSquareMat<T>::identity(base.dimension(), base.memoryResource());
+    }
+
+    // Start from the rung of the lowest set bit, then multiply in the higher ones
+    int level = 0;
+    while (((exponent >> level) & 1) == 0) {
+        ++level;
+    }
+    BasicSquareMat<T> result(*rung(level));
+    for (++level; (exponent >> level) != 0; ++level) {
+        if ((exponent >> level) & 1) {
+            result *= *rung(level);
+        }
+    }
+    return result;
+}
+
+template <typename T>
+int BasicPowerCache<T>::cachedRungs() const {
+    int count = 0;
+    for (const Rung& entry : ladder) {
+        count += (entry != nullptr);
+    }
+    return count;
+}
+
+// Capacity management
+
+template <typename T>
+void BasicPowerCache<T>::setMemoryCapacity(std::size_t bytes) {
+    capacity = bytes;
+    while (used > capacity) {
+        evictOne();
+    }
+}
+
+template <typename T>
+void BasicPowerCache<T>::clear() {
+    ladder.assign(1, nullptr);
+    lastUse.assign(1, 0);
+    used = 0;
+}
+
+// Explicit instantiations for the supported element types
+
+template class BasicPowerCache<float>;
+template class BasicPowerCache<double>;
+template class BasicPowerCache<std::int32_t>;
+template class BasicPowerCache<std::int64_t>;
+
+} // namespace matrix_ops
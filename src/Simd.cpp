@@ -0,0 +1,507 @@
+// idocohen963@gmail.com
+
+#include "../include/Simd.hpp"
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATRIX_OPS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace matrix_ops {
+namespace simd {
+
+namespace {
+
+// Portable kernels
+
+namespace scalar {
+
+constexpr int MR = 4;
+constexpr int NR = 8;
+
+void gemm(int kc, const double* a, const double* b, double* c, int ldc, double alpha, double beta) {
+    double acc[MR][NR] = {};
+    for (int k = 0; k < kc; ++k) {
+        for (int i = 0; i < MR; ++i) {
+            for (int j = 0; j < NR; ++j) {
+                acc[i][j] += a[i] * b[j];
+            }
+        }
+        a += MR;
+        b += NR;
+    }
+    for (int i = 0; i < MR; ++i) {
+        double* ci = c + i * ldc;
+        for (int j = 0; j < NR; ++j) {
+            ci[j] = (beta == 0.0) ? alpha * acc[i][j] : alpha * acc[i][j] + beta * ci[j];
+        }
+    }
+}
+
+void add(const double* a, const double* b, double* r, int n) {
+    for (int j = 0; j < n; ++j) {
+        r[j] = a[j] + b[j];
+    }
+}
+
+void subtract(const double* a, const double* b, double* r, int n) {
+    for (int j = 0; j < n; ++j) {
+        r[j] = a[j] - b[j];
+    }
+}
+
+void multiply(const double* a, const double* b, double* r, int n) {
+    for (int j = 0; j < n; ++j) {
+        r[j] = a[j] * b[j];
+    }
+}
+
+void scale(const double* a, double scalar, double* r, int n) {
+    for (int j = 0; j < n; ++j) {
+        r[j] = a[j] * scalar;
+    }
+}
+
+void divide(const double* a, double scalar, double* r, int n) {
+    for (int j = 0; j < n; ++j) {
+        r[j] = a[j] / scalar;
+    }
+}
+
+void multiplyAddWide(std::uint64_t scalar, const std::uint32_t* b, std::uint64_t* acc, int n) {
+    for (int j = 0; j < n; ++j) {
+        acc[j] += scalar * b[j];
+    }
+}
+
+} // namespace scalar
+
+const Kernels SCALAR_KERNELS = {Isa::Scalar, scalar::MR, scalar::NR, scalar::gemm, scalar::add,
+                                scalar::subtract, scalar::multiply, scalar::scale, scalar::divide,
+                                scalar::multiplyAddWide};
+
+#ifdef MATRIX_OPS_X86
+
+// SSE2 kernels: 2 doubles per vector, 4x4 GEMM tile
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+namespace sse2 {
+
+constexpr int MR = 4;
+constexpr int NR = 4;
+
+void gemm(int kc, const double* a, const double* b, double* c, int ldc, double alpha, double beta) {
+    __m128d acc[MR][2];
+    for (int i = 0; i < MR; ++i) {
+        acc[i][0] = _mm_setzero_pd();
+        acc[i][1] = _mm_setzero_pd();
+    }
+    for (int k = 0; k < kc; ++k) {
+        __m128d b0 = _mm_loadu_pd(b);
+        __m128d b1 = _mm_loadu_pd(b + 2);
+#pragma GCC unroll 4
+        for (int i = 0; i < MR; ++i) {
+            __m128d ai = _mm_set1_pd(a[i]);
+            acc[i][0] = _mm_add_pd(acc[i][0], _mm_mul_pd(ai, b0));
+            acc[i][1] = _mm_add_pd(acc[i][1], _mm_mul_pd(ai, b1));
+        }
+        a += MR;
+        b += NR;
+    }
+    __m128d va = _mm_set1_pd(alpha);
+    __m128d vb = _mm_set1_pd(beta);
+    for (int i = 0; i < MR; ++i) {
+        double* ci = c + i * ldc;
+        for (int v = 0; v < 2; ++v) {
+            __m128d r = _mm_mul_pd(va, acc[i][v]);
+            if (beta != 0.0) {
+                r = _mm_add_pd(r, _mm_mul_pd(vb, _mm_loadu_pd(ci + 2 * v)));
+            }
+            _mm_storeu_pd(ci + 2 * v, r);
+        }
+    }
+}
+
+void add(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(r + j, _mm_add_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+    }
+    scalar::add(a + j, b + j, r + j, n - j);
+}
+
+void subtract(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(r + j, _mm_sub_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+    }
+    scalar::subtract(a + j, b + j, r + j, n - j);
+}
+
+void multiply(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(r + j, _mm_mul_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+    }
+    scalar::multiply(a + j, b + j, r + j, n - j);
+}
+
+void scale(const double* a, double scalar, double* r, int n) {
+    __m128d s = _mm_set1_pd(scalar);
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(r + j, _mm_mul_pd(_mm_loadu_pd(a + j), s));
+    }
+    scalar::scale(a + j, scalar, r + j, n - j);
+}
+
+void divide(const double* a, double scalar, double* r, int n) {
+    __m128d s = _mm_set1_pd(scalar);
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(r + j, _mm_div_pd(_mm_loadu_pd(a + j), s));
+    }
+    scalar::divide(a + j, scalar, r + j, n - j);
+}
+
+// Unsigned 32 x 32 -> 64-bit products of the even lanes (pmuludq)
+void multiplyAddWide(std::uint64_t scalar, const std::uint32_t* b, std::uint64_t* acc, int n) {
+    __m128i s = _mm_set1_epi64x(static_cast<long long>(scalar));
+    int j = 0;
+    for (; j + 2 <= n; j += 2) {
+        __m128i bj = _mm_unpacklo_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + j)), _mm_setzero_si128());
+        __m128i* target = reinterpret_cast<__m128i*>(acc + j);
+        _mm_storeu_si128(target, _mm_add_epi64(_mm_loadu_si128(target), _mm_mul_epu32(bj, s)));
+    }
+    scalar::multiplyAddWide(scalar, b + j, acc + j, n - j);
+}
+
+} // namespace sse2
+
+#pragma GCC pop_options
+
+// AVX2 + FMA kernels: 4 doubles per vector, 6x8 GEMM tile (12 accumulators)
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+namespace avx2 {
+
+constexpr int MR = 6;
+constexpr int NR = 8;
+
+void gemm(int kc, const double* a, const double* b, double* c, int ldc, double alpha, double beta) {
+    __m256d acc[MR][2];
+    for (int i = 0; i < MR; ++i) {
+        acc[i][0] = _mm256_setzero_pd();
+        acc[i][1] = _mm256_setzero_pd();
+    }
+    for (int k = 0; k < kc; ++k) {
+        __m256d b0 = _mm256_loadu_pd(b);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+#pragma GCC unroll 6
+        for (int i = 0; i < MR; ++i) {
+            __m256d ai = _mm256_broadcast_sd(a + i);
+            acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += NR;
+    }
+    __m256d va = _mm256_set1_pd(alpha);
+    __m256d vb = _mm256_set1_pd(beta);
+    for (int i = 0; i < MR; ++i) {
+        double* ci = c + i * ldc;
+        for (int v = 0; v < 2; ++v) {
+            __m256d r = _mm256_mul_pd(va, acc[i][v]);
+            if (beta != 0.0) {
+                r = _mm256_fmadd_pd(vb, _mm256_loadu_pd(ci + 4 * v), r);
+            }
+            _mm256_storeu_pd(ci + 4 * v, r);
+        }
+    }
+}
+
+void add(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(r + j, _mm256_add_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j)));
+    }
+    scalar::add(a + j, b + j, r + j, n - j);
+}
+
+void subtract(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(r + j, _mm256_sub_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j)));
+    }
+    scalar::subtract(a + j, b + j, r + j, n - j);
+}
+
+void multiply(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(r + j, _mm256_mul_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j)));
+    }
+    scalar::multiply(a + j, b + j, r + j, n - j);
+}
+
+void scale(const double* a, double scalar, double* r, int n) {
+    __m256d s = _mm256_set1_pd(scalar);
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(r + j, _mm256_mul_pd(_mm256_loadu_pd(a + j), s));
+    }
+    scalar::scale(a + j, scalar, r + j, n - j);
+}
+
+void divide(const double* a, double scalar, double* r, int n) {
+    __m256d s = _mm256_set1_pd(scalar);
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(r + j, _mm256_div_pd(_mm256_loadu_pd(a + j), s));
+    }
+    scalar::divide(a + j, scalar, r + j, n - j);
+}
+
+void multiplyAddWide(std::uint64_t scalar, const std::uint32_t* b, std::uint64_t* acc, int n) {
+    __m256i s = _mm256_set1_epi64x(static_cast<long long>(scalar));
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256i bj = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j)));
+        __m256i* target = reinterpret_cast<__m256i*>(acc + j);
+        _mm256_storeu_si256(target, _mm256_add_epi64(_mm256_loadu_si256(target), _mm256_mul_epu32(bj, s)));
+    }
+    scalar::multiplyAddWide(scalar, b + j, acc + j, n - j);
+}
+
+} // namespace avx2
+
+#pragma GCC pop_options
+
+// AVX-512 kernels: 8 doubles per vector, 8x16 GEMM tile (16 accumulators)
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+
+namespace avx512 {
+
+constexpr int MR = 8;
+constexpr int NR = 16;
+
+void gemm(int kc, const double* a, const double* b, double* c, int ldc, double alpha, double beta) {
+    __m512d acc[MR][2];
+    for (int i = 0; i < MR; ++i) {
+        acc[i][0] = _mm512_setzero_pd();
+        acc[i][1] = _mm512_setzero_pd();
+    }
+    for (int k = 0; k < kc; ++k) {
+        __m512d b0 = _mm512_loadu_pd(b);
+        __m512d b1 = _mm512_loadu_pd(b + 8);
+#pragma GCC unroll 8
+        for (int i = 0; i < MR; ++i) {
+            __m512d ai = _mm512_set1_pd(a[i]);
+            acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += NR;
+    }
+    __m512d va = _mm512_set1_pd(alpha);
+    __m512d vb = _mm512_set1_pd(beta);
+    for (int i = 0; i < MR; ++i) {
+        double* ci = c + i * ldc;
+        for (int v = 0; v < 2; ++v) {
+            __m512d r = _mm512_mul_pd(va, acc[i][v]);
+            if (beta != 0.0) {
+                r = _mm512_fmadd_pd(vb, _mm512_loadu_pd(ci + 8 * v), r);
+            }
+            _mm512_storeu_pd(ci + 8 * v, r);
+        }
+    }
+}
+
+void add(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(r + j, _mm512_add_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(b + j)));
+    }
+    if (j < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - j)) - 1);
+        __m512d x = _mm512_maskz_loadu_pd(tail, a + j);
+        __m512d y = _mm512_maskz_loadu_pd(tail, b + j);
+        _mm512_mask_storeu_pd(r + j, tail, _mm512_maskz_add_pd(tail, x, y));
+    }
+}
+
+void subtract(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(r + j, _mm512_sub_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(b + j)));
+    }
+    if (j < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - j)) - 1);
+        __m512d x = _mm512_maskz_loadu_pd(tail, a + j);
+        __m512d y = _mm512_maskz_loadu_pd(tail, b + j);
+        _mm512_mask_storeu_pd(r + j, tail, _mm512_maskz_sub_pd(tail, x, y));
+    }
+}
+
+void multiply(const double* a, const double* b, double* r, int n) {
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(r + j, _mm512_mul_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(b + j)));
+    }
+    if (j < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - j)) - 1);
+        __m512d x = _mm512_maskz_loadu_pd(tail, a + j);
+        __m512d y = _mm512_maskz_loadu_pd(tail, b + j);
+        _mm512_mask_storeu_pd(r + j, tail, _mm512_maskz_mul_pd(tail, x, y));
+    }
+}
+
+void scale(const double* a, double scalar, double* r, int n) {
+    __m512d s = _mm512_set1_pd(scalar);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(r + j, _mm512_mul_pd(_mm512_loadu_pd(a + j), s));
+    }
+    if (j < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - j)) - 1);
+        __m512d x = _mm512_maskz_loadu_pd(tail, a + j);
+        _mm512_mask_storeu_pd(r + j, tail, _mm512_maskz_mul_pd(tail, x, s));
+    }
+}
+
+void divide(const double* a, double scalar, double* r, int n) {
+    __m512d s = _mm512_set1_pd(scalar);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(r + j, _mm512_div_pd(_mm512_loadu_pd(a + j), s));
+    }
+    if (j < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - j)) - 1);
+        __m512d x = _mm512_maskz_loadu_pd(tail, a + j);
+        _mm512_mask_storeu_pd(r + j, tail, _mm512_maskz_div_pd(tail, x, s));
+    }
+}
+
+void multiplyAddWide(std::uint64_t scalar, const std::uint32_t* b, std::uint64_t* acc, int n) {
+    __m512i s = _mm512_set1_epi64(static_cast<long long>(scalar));
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m512i bj = _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j)));
+        std::uint64_t* target = acc + j;
+        _mm512_storeu_si512(target, _mm512_add_epi64(_mm512_loadu_si512(target), _mm512_mul_epu32(bj, s)));
+    }
+    scalar::multiplyAddWide(scalar, b + j, acc + j, n - j);
+}
+
+} // namespace avx512
+
+#pragma GCC pop_options
+
+const Kernels SSE2_KERNELS = {Isa::SSE2, sse2::MR, sse2::NR, sse2::gemm, sse2::add,
+                              sse2::subtract, sse2::multiply, sse2::scale, sse2::divide,
+                              sse2::multiplyAddWide};
+const Kernels AVX2_KERNELS = {Isa::AVX2, avx2::MR, avx2::NR, avx2::gemm, avx2::add,
+                              avx2::subtract, avx2::multiply, avx2::scale, avx2::divide,
+                              avx2::multiplyAddWide};
+const Kernels AVX512_KERNELS = {Isa::AVX512, avx512::MR, avx512::NR, avx512::gemm, avx512::add,
+                                avx512::subtract, avx512::multiply, avx512::scale, avx512::divide,
+                                avx512::multiplyAddWide};
+
+#endif // MATRIX_OPS_X86
+
+bool supports(Isa isa) {
+#ifdef MATRIX_OPS_X86
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+        case Isa::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case Isa::AVX512:
+            // The AVX-512 kernels are compiled on top of the AVX2/FMA baseline, so require it too
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    return false;
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+const Kernels& tableFor(Isa isa) {
+#ifdef MATRIX_OPS_X86
+    switch (isa) {
+        case Isa::SSE2:
+            return SSE2_KERNELS;
+        case Isa::AVX2:
+            return AVX2_KERNELS;
+        case Isa::AVX512:
+            return AVX512_KERNELS;
+        case Isa::Scalar:
+            break;
+    }
+#endif
+    return SCALAR_KERNELS;
+}
+
+// Kernel table in use; chosen from cpuid on first use
+std::atomic<const Kernels*>& activeTable() {
+    static std::atomic<const Kernels*> table(&tableFor(detectedIsa()));
+    return table;
+}
+
+} // namespace
+
+Isa detectedIsa() {
+    static const Isa best = [] {
+        for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::SSE2}) {
+            if (supports(isa)) {
+                return isa;
+            }
+        }
+        return Isa::Scalar;
+    }();
+    return best;
+}
+
+Isa activeIsa() {
+    return kernels().isa;
+}
+
+void setActiveIsa(Isa isa) {
+    if (!supports(isa)) {
+        throw std::invalid_argument("Instruction set not supported by this CPU");
+    }
+    activeTable().store(&tableFor(isa));
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return "Scalar";
+        case Isa::SSE2:
+            return "SSE2";
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::AVX512:
+            return "AVX512";
+    }
+    return "Unknown";
+}
+
+const Kernels& kernels() {
+    return *activeTable().load(std::memory_order_relaxed);
+}
+
+} // namespace simd
+} // namespace matrix_ops
@@ -1,149 +1,441 @@
 // idocohen963@gmail.com
 
 #include "../include/SquareMat.hpp"
+#include "../include/BufferPool.hpp"
+#include "../include/Gemm.hpp"
+#include "../include/Simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace matrix_ops {
 
+namespace {
+
+// Row kernels behind the elementwise operators; double rows use the runtime-dispatched SIMD kernels
+
+template <typename T>
+void addRow(const T* a, const T* b, T* r, int n) {
+    if constexpr (std::is_same_v<T, double>) {
+        simd::kernels().add(a, b, r, n);
+    } else {
+        for (int j = 0; j < n; ++j) {
+            r[j] = a[j] + b[j];
+        }
+    }
+}
+
+template <typename T>
+void subtractRow(const T* a, const T* b, T* r, int n) {
+    if constexpr (std::is_same_v<T, double>) {
+        simd::kernels().subtract(a, b, r, n);
+    } else {
+        for (int j = 0; j < n; ++j) {
+            r[j] = a[j] - b[j];
+        }
+    }
+}
+
+template <typename T>
+void multiplyRow(const T* a, const T* b, T* r, int n) {
+    if constexpr (std::is_same_v<T, double>) {
+        simd::kernels().multiply(a, b, r, n);
+    } else {
+        for (int j = 0; j < n; ++j) {
+            r[j] = a[j] * b[j];
+        }
+    }
+}
+
+template <typename T>
+void scaleRow(const T* a, T scalar, T* r, int n) {
+    if constexpr (std::is_same_v<T, double>) {
+        simd::kernels().scale(a, scalar, r, n);
+    } else {
+        for (int j = 0; j < n; ++j) {
+            r[j] = a[j] * scalar;
+        }
+    }
+}
+
+template <typename T>
+void divideRow(const T* a, T scalar, T* r, int n) {
+    if constexpr (std::is_same_v<T, double>) {
+        simd::kernels().divide(a, scalar, r, n);
+    } else {
+        for (int j = 0; j < n; ++j) {
+            r[j] = a[j] / scalar;
+        }
+    }
+}
+
+// y[0, n) -= factor * x[0, n), the row update of the LU factorization and its substitutions
+template <typename F>
+void subtractScaledRow(const F* x, F factor, F* y, int n) {
+    for (int j = 0; j < n; ++j) {
+        y[j] -= factor * x[j];
+    }
+}
+
+__extension__ typedef __int128 int128;
+
+// a * b - c * d into result, or false if a step leaves the 128-bit range
+bool crossDifference(int128 a, int128 b, int128 c, int128 d, int128& result) {
+    int128 ab;
+    int128 cd;
+    return !__builtin_mul_overflow(a, b, &ab) && !__builtin_mul_overflow(c, d, &cd) &&
+           !__builtin_sub_overflow(ab, cd, &result);
+}
+
+// Inverse of an integer matrix by fraction-free Gauss-Jordan elimination (Bareiss) of [A | I].
+// Every intermediate is a minor of [A | I] and every division is exact, so the elimination ends
+// at [d I | d A^-1] with d = +-det(A) computed exactly. A^-1 is integral only when d = +-1.
+template <typename T>
+std::vector<T> unimodularInverse(const T* a, int lda, int n) {
+    const int width = 2 * n;
+    std::vector<int128> m(static_cast<std::size_t>(n) * width, 0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            m[i * width + j] = a[i * lda + j];
+        }
+        m[i * width + n + i] = 1;
+    }
+
+    int128 previous = 1;
+    for (int k = 0; k < n; ++k) {
+        int pivot = k;
+        while (pivot < n && m[pivot * width + k] == 0) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            throw std::invalid_argument("Matrix is singular and has no inverse");
+        }
+        if (pivot != k) {
+            std::swap_ranges(m.begin() + k * width, m.begin() + (k + 1) * width, m.begin() + pivot * width);
+        }
+        const int128* top = &m[k * width];
+        for (int i = 0; i < n; ++i) {
+            if (i == k) {
+                continue;
+            }
+            int128* row = &m[i * width];
+            for (int j = 0; j < width; ++j) {
+                if (j == k) {
+                    continue;
+                }
+                int128 minor;
+                if (!crossDifference(top[k], row[j], row[k], top[j], minor)) {
+                    throw std::overflow_error("Integer inverse needs intermediates wider than 128 bits");
+                }
+                row[j] = minor / previous;
+            }
+            row[k] = 0;
+        }
+        previous = top[k];
+    }
+
+    if (previous != 1 && previous != -1) {
+        throw std::invalid_argument("Matrix has no inverse with integer elements");
+    }
+    std::vector<T> inverse(static_cast<std::size_t>(n) * n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            const int128 value = m[i * width + n + j] * previous;
+            if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+                throw std::invalid_argument("Matrix has no inverse with integer elements");
+            }
+            inverse[i * n + j] = static_cast<T>(value);
+        }
+    }
+    return inverse;
+}
+
+// Product of two polynomials of degree < n reduced modulo the monic chi of degree n
+// (coefficients lowest degree first), using x^n = -(chi[0] + chi[1] x + ... + chi[n-1] x^(n-1))
+template <typename T>
+std::vector<T> multiplyPolynomials(const std::vector<T>& a, const std::vector<T>& b, const std::vector<T>& chi) {
+    const int n = static_cast<int>(chi.size()) - 1;
+    std::vector<T> full(2 * n - 1, T());
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            full[i + j] += a[i] * b[j];
+        }
+    }
+    for (int d = 2 * n - 2; d >= n; --d) {
+        T lead = full[d];
+        for (int j = 0; j < n; ++j) {
+            full[d - n + j] -= lead * chi[j];
+        }
+    }
+    full.resize(n);
+    return full;
+}
+
+} // namespace
+
 // Private helper methods
 
-double SquareMat::sum() const {
-    double result = 0.0;
+template <typename T>
+T BasicSquareMat<T>::sum() const {
+    T result = T();
     for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
-            result += matrix[i][j];
+            result += elements()[i * stride + j];
         }
     }
     return result;
 }
 
 // Returns the remainder of a divided by b, always non-negative if b > 0
-double SquareMat::modulo(double a, int b) const {
-    int q = (int)(a / b);  // Truncate towards zero (not always like floor)
-    if (a < 0 && a != b * q) {
-        q -= 1;  // Correction if a is negative and not divisible by b
+template <typename T>
+T BasicSquareMat<T>::modulo(T a, int b) const {
+    if constexpr (std::is_integral_v<T>) {
+        // Exact integer remainder, shifted into [0, b)
+        T r = a % static_cast<T>(b);
+        return r < 0 ? r + static_cast<T>(b) : r;
+    } else {
+        int q = (int)(a / b);  // Truncate towards zero (not always like floor)
+        if (a < 0 && a != b * q) {
+            q -= 1;  // Correction if a is negative and not divisible by b
+        }
+        return a - b * q;
     }
-    return a - b * q;
 }
 
-double SquareMat::determinantHelper(double** mat, int n) const {
+template <typename T>
+T BasicSquareMat<T>::determinantHelper(const T* mat, int ld, const int* rows, int* cols, int n) {
+    const T* top = mat + rows[0] * ld;
     // Base cases
     if (n == 1) {
-        return mat[0][0];
+        return top[cols[0]];
     }
     if (n == 2) {
-        return mat[0][0] * mat[1][1] - mat[0][1] * mat[1][0];
+        const T* next = mat + rows[1] * ld;
+        return top[cols[0]] * next[cols[1]] - top[cols[1]] * next[cols[0]];
     }
 
-    double det = 0.0;
+    T det = T();
     int sign = 1;
     
-    // Allocate memory for minor matrix
-    double** minor = new double*[n-1];
-    for (int i = 0; i < n-1; ++i) {
-        minor[i] = new double[n-1];
-    }
-    
-    // Calculate determinant using cofactor expansion along first row
+    // Calculate determinant using cofactor expansion along the first remaining row
     for (int j = 0; j < n; ++j) {
-        // Create minor matrix by excluding first row and current column
-        for (int i = 1; i < n; ++i) {
-            int col_index = 0;
-            for (int j2 = 0; j2 < n; ++j2) {
-                if (j2 == j) continue;
-                minor[i-1][col_index++] = mat[i][j2];
-            }
-        }
+        // Move column j behind the active range, keeping the order of the others,
+        // so the minor is the remaining rows restricted to cols[0 .. n-2]
+        std::rotate(cols + j, cols + j + 1, cols + n);
+        T cofactor = determinantHelper(mat, ld, rows + 1, cols, n - 1);
+        std::rotate(cols + j, cols + n - 1, cols + n);
         
         // Add cofactor to determinant
-        det += sign * mat[0][j] * determinantHelper(minor, n-1);
+        det += sign * top[cols[j]] * cofactor;
         sign = -sign;
     }
     
-    // Free memory
-    for (int i = 0; i < n-1; ++i) {
-        delete[] minor[i];
-    }
-    delete[] minor;
-    
     return det;
 }
 
+template <typename T>
+void BasicSquareMat<T>::product(MatrixView<const T> a, MatrixView<const T> b, BasicSquareMat& result, int threads) {
+    if (gemm::algorithm() == gemm::Algorithm::StrassenWinograd) {
+        gemm::multiplyStrassen(result.size, a.data(), a.leadingDimension(), b.data(), b.leadingDimension(),
+                               result.elements(), result.stride, threads);
+    } else {
+        gemm::multiply(result.size, T(1), a.data(), a.leadingDimension(), b.data(), b.leadingDimension(),
+                       T(), result.elements(), result.stride, threads);
+    }
+}
+
+template <typename T>
+bool BasicSquareMat<T>::overlaps(MatrixView<const T> other) const {
+    const T* begin = elements();
+    const T* end = begin + (size - 1) * stride + size;
+    const T* otherBegin = other.data();
+    const T* otherEnd = other.row(other.dimension() - 1) + other.dimension();
+    std::less<const T*> before;
+    return before(otherBegin, end) && before(begin, otherEnd);
+}
+
+template <typename T>
+std::pmr::memory_resource* BasicSquareMat<T>::checkedResource(std::pmr::memory_resource* resource) {
+    if (resource == nullptr) {
+        throw std::invalid_argument("Memory resource cannot be null");
+    }
+    return resource;
+}
+
+template <typename T>
+T* BasicSquareMat<T>::allocate(int count) const {
+    if (resource == std::pmr::new_delete_resource()) {
+        BufferPool* pool = BufferPool::localIfAlive();
+        if (pool != nullptr) {
+            void* cached = pool->acquire(count * sizeof(T));
+            if (cached != nullptr) {
+                return static_cast<T*>(cached);
+            }
+        }
+    }
+    return static_cast<T*>(resource->allocate(count * sizeof(T), ALIGNMENT));
+}
+
+template <typename T>
+void BasicSquareMat<T>::deallocate(T* ptr, int count) const {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (resource == std::pmr::new_delete_resource()) {
+        BufferPool* pool = BufferPool::localIfAlive();
+        if (pool != nullptr && pool->release(ptr, count * sizeof(T))) {
+            return;
+        }
+    }
+    resource->deallocate(ptr, count * sizeof(T), ALIGNMENT);
+}
+
+
+template <typename T>
+int BasicSquareMat<T>::paddedStride(int n) {
+    if (n <= INLINE_SIZE) {
+        return n;
+    }
+    // Round rows up to whole cache lines so every row starts aligned
+    const int lineElements = static_cast<int>(ALIGNMENT / sizeof(T));
+    int ld = (n + lineElements - 1) / lineElements * lineElements;
+    // Rows spaced by a multiple of 512 bytes fall into the same few cache sets
+    // during column walks; one extra line breaks the aliasing
+    if ((ld * sizeof(T)) % ALIASING_PERIOD == 0) {
+        ld += lineElements;
+    }
+    return ld;
+}
+
+template <typename T>
+void BasicSquareMat<T>::acquireStorage(int n) {
+    size = n;
+    stride = paddedStride(n);
+    heap = (n > INLINE_SIZE) ? allocate(n * stride) : nullptr;
+}
+
+template <typename T>
+void BasicSquareMat<T>::releaseStorage() {
+    deallocate(heap, size * stride);
+    heap = nullptr;
+}
+
 
 // Constructors and destructor
 
-SquareMat::SquareMat(int size) {
+template <typename T>
+BasicSquareMat<T>::BasicSquareMat(int size, std::pmr::memory_resource* resource)
+    : heap(nullptr), resource(checkedResource(resource)) {
     if (size <= 0) {
         throw std::length_error("Matrix size must be positive");
     }
     
-    this->size = size;
-    matrix = new double*[size];
-    
-    for (int i = 0; i < size; ++i) {
-        matrix[i] = new double[size];
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] = 0.0;
-        }
-    }
+    acquireStorage(size);
+    T* buffer = elements();
+    std::fill(buffer, buffer + size * stride, T());
 }
 
-SquareMat::SquareMat(const SquareMat& other) : size(other.size) {
-    matrix = new double*[size];
-    
+template <typename T>
+BasicSquareMat<T>::BasicSquareMat(const BasicSquareMat& other) : BasicSquareMat(other, other.resource) {}
+
+template <typename T>
+BasicSquareMat<T>::BasicSquareMat(const BasicSquareMat& other, std::pmr::memory_resource* resource)
+    : heap(nullptr), resource(checkedResource(resource)) {
+    acquireStorage(other.size);
+    std::copy(other.elements(), other.elements() + size * stride, elements());
+}
+
+template <typename T>
+BasicSquareMat<T>::BasicSquareMat(MatrixView<const T> source, std::pmr::memory_resource* resource)
+    : heap(nullptr), resource(checkedResource(resource)) {
+    acquireStorage(source.dimension());
+    T* buffer = elements();
+    std::fill(buffer, buffer + size * stride, T());
     for (int i = 0; i < size; ++i) {
-        matrix[i] = new double[size];
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] = other.matrix[i][j];
-        }
+        std::copy(source.row(i), source.row(i) + size, buffer + i * stride);
     }
 }
 
-SquareMat::~SquareMat() {
-    if (matrix != nullptr) {
-        for (int i = 0; i < size; ++i) {
-            delete[] matrix[i];
-        }
-        delete[] matrix;
+template <typename T>
+BasicSquareMat<T>::BasicSquareMat(BasicSquareMat&& other) noexcept
+    : heap(other.heap), size(other.size), stride(other.stride), resource(other.resource) {
+    if (heap == nullptr) {
+        // Inline storage cannot be stolen; it is at most INLINE_SIZE^2 elements
+        std::copy(other.local, other.local + size * stride, local);
     }
+    other.heap = nullptr;
+    other.size = 0;
+    other.stride = 0;
+}
+
+template <typename T>
+BasicSquareMat<T>::~BasicSquareMat() {
+    releaseStorage();
 }
 
 // Assignment operators
 
-SquareMat& SquareMat::operator=(const SquareMat& other) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator=(const BasicSquareMat& other) {
     if (this == &other) {
         return *this;
     }
     
-    // Clean up existing resources
-    for (int i = 0; i < size; ++i) {
-        delete[] matrix[i];
+    // Reuse the existing storage when the dimensions already match
+    if (size != other.size) {
+        T* fresh = (other.size > INLINE_SIZE) ? allocate(other.size * other.stride) : nullptr;
+        releaseStorage();
+        heap = fresh;
+        size = other.size;
+        stride = other.stride;
     }
-    delete[] matrix;
+    std::copy(other.elements(), other.elements() + size * stride, elements());
     
-    // Copy from other
-    size = other.size;
-    matrix = new double*[size];
+    return *this;
+}
+
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator=(BasicSquareMat&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    // A buffer from another resource may not outlive that resource; copy it into ours instead
+    if (*resource != *other.resource) {
+        return *this = static_cast<const BasicSquareMat&>(other);
+    }
     
-    for (int i = 0; i < size; ++i) {
-        matrix[i] = new double[size];
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] = other.matrix[i][j];
-        }
+    releaseStorage();
+    heap = other.heap;
+    size = other.size;
+    stride = other.stride;
+    if (heap == nullptr) {
+        std::copy(other.local, other.local + size * stride, local);
     }
     
+    other.heap = nullptr;
+    other.size = 0;
+    other.stride = 0;
+    
     return *this;
 }
 
 // Static methods
 
-SquareMat SquareMat::identity(int size) {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::identity(int size, std::pmr::memory_resource* resource) {
     if (size <= 0) {
         throw std::length_error("Matrix size must be positive");
     }
     
-    SquareMat result(size);
+    BasicSquareMat result(size, resource);
+    T* buffer = result.elements();
     for (int i = 0; i < size; ++i) {
-        result.matrix[i][i] = 1.0;
+        buffer[i * result.stride + i] = T(1);
     }
     
     return result;
@@ -151,347 +443,778 @@ SquareMat SquareMat::identity(int size) {
 
 // Access operators
 
-SquareMat::RowProxy SquareMat::operator[](int row) {
+template <typename T>
+typename BasicSquareMat<T>::RowProxy BasicSquareMat<T>::operator[](int row) {
     if (row < 0 || row >= size) {
         throw std::out_of_range("Row index out of range");
     }
-    return RowProxy(matrix[row], size);
+    return RowProxy(elements() + row * stride, size);
 }
 
-const SquareMat::RowProxy SquareMat::operator[](int row) const {
+template <typename T>
+const typename BasicSquareMat<T>::RowProxy BasicSquareMat<T>::operator[](int row) const {
     if (row < 0 || row >= size) {
         throw std::out_of_range("Row index out of range");
     }
-    return RowProxy(matrix[row], size);
+    return RowProxy(const_cast<T*>(elements()) + row * stride, size);
+}
+
+// Views
+
+template <typename T>
+MatrixView<T> BasicSquareMat<T>::view() {
+    return MatrixView<T>(elements(), size, stride);
+}
+
+template <typename T>
+MatrixView<const T> BasicSquareMat<T>::view() const {
+    return MatrixView<const T>(elements(), size, stride);
+}
+
+template <typename T>
+MatrixView<T> BasicSquareMat<T>::block(int row, int col, int n) {
+    return view().block(row, col, n);
+}
+
+template <typename T>
+MatrixView<const T> BasicSquareMat<T>::block(int row, int col, int n) const {
+    return view().block(row, col, n);
 }
 
 // Arithmetic operators
 
-SquareMat SquareMat::operator+(const SquareMat& other) const {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator+(const BasicSquareMat& other) const & {
+    return *this + other.view();
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator+(MatrixView<const T> other) const {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for addition");
     }
     
-    SquareMat result(size);
+    BasicSquareMat result(size, resource);
+    T* target = result.elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = matrix[i][j] + other.matrix[i][j];
-        }
+        addRow(elements() + i * stride, other.row(i), target + i * stride, size);
     }
     
     return result;
 }
 
-SquareMat SquareMat::operator-(const SquareMat& other) const {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator+(const BasicSquareMat& other) && {
+    *this += other;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator+(BasicSquareMat&& other) const & {
+    // The result belongs to this matrix's resource; other's buffer is only reused if it is drawn from an equal one
+    if (*other.resource != *resource) {
+        return *this + std::as_const(other).view();
+    }
+    other += *this;
+    return std::move(other);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator+(BasicSquareMat&& other) && {
+    *this += other;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator-(const BasicSquareMat& other) const & {
+    return *this - other.view();
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator-(MatrixView<const T> other) const {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for subtraction");
     }
     
-    SquareMat result(size);
+    BasicSquareMat result(size, resource);
+    T* target = result.elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = matrix[i][j] - other.matrix[i][j];
-        }
+        subtractRow(elements() + i * stride, other.row(i), target + i * stride, size);
     }
     
     return result;
 }
 
-SquareMat SquareMat::operator-() const {
-    SquareMat result(size);
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator-(const BasicSquareMat& other) && {
+    *this -= other;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator-(BasicSquareMat&& other) const & {
+    // The result belongs to this matrix's resource; other's buffer is only reused if it is drawn from an equal one
+    if (*other.resource != *resource) {
+        return *this - std::as_const(other).view();
+    }
+    if (size != other.size) {
+        throw std::invalid_argument("Matrix sizes do not match for subtraction");
+    }
+    
+    T* buffer = other.elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = -matrix[i][j];
-        }
+        subtractRow(elements() + i * stride, buffer + i * stride, buffer + i * stride, size);
+    }
+    
+    return std::move(other);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator-(BasicSquareMat&& other) && {
+    *this -= other;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator-() const & {
+    BasicSquareMat result(size, resource);
+    T* target = result.elements();
+    for (int i = 0; i < size; ++i) {
+        scaleRow(elements() + i * stride, T(-1), target + i * stride, size);
     }
     
     return result;
 }
 
-SquareMat SquareMat::operator*(const SquareMat& other) const {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator-() && {
+    T* buffer = elements();
+    for (int i = 0; i < size; ++i) {
+        scaleRow(buffer + i * stride, T(-1), buffer + i * stride, size);
+    }
+    
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator*(const BasicSquareMat& other) const {
+    return *this * other.view();
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator*(MatrixView<const T> other) const {
+    return multiply(other, 0);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::multiply(MatrixView<const T> other, int threads) const {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for multiplication");
     }
+    if (threads < 0) {
+        throw std::invalid_argument("Thread count cannot be negative");
+    }
     
-    SquareMat result(size);
-    for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            double sum = 0.0;
-            for (int k = 0; k < size; ++k) {
-                sum += matrix[i][k] * other.matrix[k][j];
-            }
-            result.matrix[i][j] = sum;
-        }
+    BasicSquareMat result(size, resource);
+    product(view(), other, result, threads);
+    return result;
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::gram(int threads) const {
+    if (threads < 0) {
+        throw std::invalid_argument("Thread count cannot be negative");
     }
     
+    BasicSquareMat result(size, resource);
+    gemm::gram(size, T(1), elements(), stride, T(), result.elements(), result.stride, threads);
     return result;
 }
 
-SquareMat SquareMat::operator*(double scalar) const {
-    SquareMat result(size);
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator*(T scalar) const & {
+    BasicSquareMat result(size, resource);
+    T* target = result.elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = matrix[i][j] * scalar;
-        }
+        scaleRow(elements() + i * stride, scalar, target + i * stride, size);
     }
     
     return result;
 }
 
-SquareMat operator*(double scalar, const SquareMat& mat) {
-    return mat * scalar;
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator*(T scalar) && {
+    *this *= scalar;
+    return std::move(*this);
 }
 
-SquareMat SquareMat::operator%(const SquareMat& other) const {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator%(const BasicSquareMat& other) const & {
+    return *this % other.view();
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator%(MatrixView<const T> other) const {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for element-wise multiplication");
     }
     
-    SquareMat result(size);
+    BasicSquareMat result(size, resource);
+    T* target = result.elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = matrix[i][j] * other.matrix[i][j];
-        }
+        multiplyRow(elements() + i * stride, other.row(i), target + i * stride, size);
     }
     
     return result;
 }
 
-SquareMat SquareMat::operator%(int scalar) const {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator%(const BasicSquareMat& other) && {
+    *this %= other;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator%(BasicSquareMat&& other) const & {
+    // The result belongs to this matrix's resource; other's buffer is only reused if it is drawn from an equal one
+    if (*other.resource != *resource) {
+        return *this % std::as_const(other).view();
+    }
+    other %= *this;
+    return std::move(other);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator%(BasicSquareMat&& other) && {
+    *this %= other;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator%(int scalar) const & {
     if (scalar <= 0) {
         throw std::invalid_argument("Cannot perform modulo by zero or negative number");
     }
     
-    SquareMat result(size);
+    BasicSquareMat result(size, resource);
+    T* target = result.elements();
     for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = modulo(matrix[i][j], scalar);
+            target[i * stride + j] = modulo(elements()[i * stride + j], scalar);
             
             }
         }
     return result;
 }
 
-SquareMat SquareMat::operator/(double scalar) const {
-    if (scalar == 0.0) {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator%(int scalar) && {
+    *this %= scalar;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator/(T scalar) const & {
+    if (scalar == T()) {
         throw std::invalid_argument("Cannot divide by zero");
     }
     
-    SquareMat result(size);
+    BasicSquareMat result(size, resource);
+    T* target = result.elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = matrix[i][j] / scalar;
-        }
+        divideRow(elements() + i * stride, scalar, target + i * stride, size);
     }
     
     return result;
 }
 
-SquareMat SquareMat::operator^(int power) const {
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator/(T scalar) && {
+    *this /= scalar;
+    return std::move(*this);
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator^(int power) const {
     if (power < 0) {
-        throw std::invalid_argument("Negative powers are not supported (inverse not implemented)");
+        return inverse().powerBySquaring(static_cast<std::uint64_t>(-static_cast<std::int64_t>(power)));
+    }
+    return powerBySquaring(static_cast<std::uint64_t>(power));
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::inverse() const {
+    const int n = size;
+    if constexpr (std::is_integral_v<T>) {
+        std::vector<T> inv = unimodularInverse(elements(), stride, n);
+        BasicSquareMat result(n, resource);
+        T* target = result.elements();
+        for (int i = 0; i < n; ++i) {
+            std::copy(inv.begin() + i * n, inv.begin() + (i + 1) * n, target + i * result.stride);
+        }
+        return result;
+    } else {
+        std::vector<T> lu(static_cast<std::size_t>(n) * n);
+        std::vector<T> inv(static_cast<std::size_t>(n) * n, T());
+        // Largest magnitude in each original row and column, the scale a pivot is measured against
+        std::vector<T> rowScale(n, T());
+        std::vector<T> columnScale(n, T());
+        std::vector<int> origin(n);
+        for (int i = 0; i < n; ++i) {
+            const T* row = elements() + i * stride;
+            for (int j = 0; j < n; ++j) {
+                lu[i * n + j] = row[j];
+                rowScale[i] = std::max(rowScale[i], std::abs(row[j]));
+                columnScale[j] = std::max(columnScale[j], std::abs(row[j]));
+            }
+            inv[i * n + i] = T(1);
+            origin[i] = i;
+        }
+        
+        // Factorize P A = L U in place, applying the same row swaps to the identity. A pivot is zero
+        // to working precision when it is negligible next to both its original row and its column,
+        // so badly scaled but regular matrices such as diag(1e-20, 1) still invert
+        const T epsilon = static_cast<T>(n) * std::numeric_limits<T>::epsilon();
+        for (int k = 0; k < n; ++k) {
+            int pivot = k;
+            for (int i = k + 1; i < n; ++i) {
+                if (std::abs(lu[i * n + k]) > std::abs(lu[pivot * n + k])) {
+                    pivot = i;
+                }
+            }
+            const T scale = std::min(rowScale[origin[pivot]], columnScale[k]);
+            if (std::abs(lu[pivot * n + k]) <= epsilon * scale) {
+                throw std::invalid_argument("Matrix is singular and has no inverse");
+            }
+            if (pivot != k) {
+                std::swap_ranges(lu.begin() + k * n, lu.begin() + (k + 1) * n, lu.begin() + pivot * n);
+                std::swap_ranges(inv.begin() + k * n, inv.begin() + (k + 1) * n, inv.begin() + pivot * n);
+                std::swap(origin[k], origin[pivot]);
+            }
+            for (int i = k + 1; i < n; ++i) {
+                T factor = lu[i * n + k] /= lu[k * n + k];
+                subtractScaledRow(&lu[k * n + k + 1], factor, &lu[i * n + k + 1], n - k - 1);
+            }
+        }
+        
+        // Forward substitution with unit L, then back substitution with U, on all columns at once
+        for (int i = 1; i < n; ++i) {
+            for (int k = 0; k < i; ++k) {
+                subtractScaledRow(&inv[k * n], lu[i * n + k], &inv[i * n], n);
+            }
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            for (int k = i + 1; k < n; ++k) {
+                subtractScaledRow(&inv[k * n], lu[i * n + k], &inv[i * n], n);
+            }
+            const T diagonal = lu[i * n + i];
+            for (int j = 0; j < n; ++j) {
+                inv[i * n + j] /= diagonal;
+            }
+        }
+        
+        BasicSquareMat result(n, resource);
+        T* target = result.elements();
+        for (int i = 0; i < n; ++i) {
+            std::copy(inv.begin() + i * n, inv.begin() + (i + 1) * n, target + i * result.stride);
+        }
+        return result;
+    }
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::power(std::uint64_t exponent, PowerStrategy strategy) const {
+    if (strategy == PowerStrategy::Automatic) {
+        strategy = selectPowerStrategy(size, exponent);
+    }
+    return (strategy == PowerStrategy::CayleyHamilton) ? powerByCayleyHamilton(exponent) : powerBySquaring(exponent);
+}
+
+template <typename T>
+PowerStrategy BasicSquareMat<T>::selectPowerStrategy(int size, std::uint64_t exponent) {
+    // Faddeev-LeVerrier and Horner lose accuracy on floating-point matrices with spread eigenvalues
+    if (!std::is_integral_v<T> || exponent < 2) {
+        return PowerStrategy::Squaring;
     }
-    if (power == 0) {
-        return identity(size);
+    int squarings = 63 - __builtin_clzll(exponent);
+    int products = __builtin_popcountll(exponent) - 1;
+    return (2 * size - 2 < squarings + products) ? PowerStrategy::CayleyHamilton : PowerStrategy::Squaring;
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::powerBySquaring(std::uint64_t exponent) const {
+    if (exponent == 0) {
+        return identity(size, resource);
     }
-    if (power == 1) {
+    if (exponent == 1) {
         return *this;
     }
-    SquareMat result = *this;
-    int p = power-1;
-    while(p != 0){
-        result *= *this;
-        p--;
+    
+    // base holds this^(2^i); every product is written to scratch and swapped in
+    BasicSquareMat base = *this;
+    BasicSquareMat scratch(size, resource);
+    std::uint64_t p = exponent;
+    // Square away the low zero bits first, so result starts as a copy instead of the identity
+    while ((p & 1u) == 0) {
+        product(base.view(), base.view(), scratch, 0);
+        std::swap(base, scratch);
+        p >>= 1;
+    }
+    BasicSquareMat result = base;
+    p >>= 1;
+    while (p != 0) {
+        product(base.view(), base.view(), scratch, 0);
+        std::swap(base, scratch);
+        if (p & 1u) {
+            product(result.view(), base.view(), scratch, 0);
+            std::swap(result, scratch);
+        }
+        p >>= 1;
     }
     return result;
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::powerByCayleyHamilton(std::uint64_t exponent) const {
+    if (size == 0 || exponent < static_cast<std::uint64_t>(size)) {
+        // x^p is already reduced; squaring is at least as cheap
+        return powerBySquaring(exponent);
+    }
     
+    std::vector<T> chi = characteristicPolynomial();
+    // r = x^p mod chi, by binary exponentiation starting from x mod chi
+    std::vector<T> r(size, T());
+    std::vector<T> base(size, T());
+    r[0] = T(1);
+    if (size == 1) {
+        base[0] = -chi[0];
+    } else {
+        base[1] = T(1);
+    }
+    for (std::uint64_t p = exponent; p != 0; p >>= 1) {
+        if (p & 1u) {
+            r = multiplyPolynomials(r, base, chi);
+        }
+        if (p > 1) {
+            base = multiplyPolynomials(base, base, chi);
+        }
+    }
+    
+    // Horner: r(A) = (...(r[n-1] A + r[n-2] I) A + ...) A + r[0] I
+    BasicSquareMat result = identity(size, resource) * r[size - 1];
+    BasicSquareMat scratch(size, resource);
+    for (int i = size - 2; i >= 0; --i) {
+        product(result.view(), view(), scratch, 0);
+        std::swap(result, scratch);
+        T* diagonal = result.elements();
+        for (int d = 0; d < size; ++d) {
+            diagonal[d * result.stride + d] += r[i];
+        }
+    }
+    return result;
+}
+
+template <typename T>
+std::vector<T> BasicSquareMat<T>::characteristicPolynomial() const {
+    // Faddeev-LeVerrier: M_1 = I, c[n-1] = -tr(A); M_k = A M_(k-1) + c[n-k+1] I, c[n-k] = -tr(A M_k) / k
+    std::vector<T> c(size + 1, T());
+    c[size] = T(1);
+    if (size == 0) {
+        return c;
+    }
+    BasicSquareMat am = *this;
+    BasicSquareMat m(size, resource);
+    auto trace = [&](const BasicSquareMat& mat) {
+        T sum = T();
+        for (int d = 0; d < size; ++d) {
+            sum += mat.elements()[d * mat.stride + d];
+        }
+        return sum;
+    };
+    c[size - 1] = -trace(am);
+    for (int k = 2; k <= size; ++k) {
+        std::swap(m, am);
+        T* diagonal = m.elements();
+        for (int d = 0; d < size; ++d) {
+            diagonal[d * m.stride + d] += c[size - k + 1];
+        }
+        product(view(), m.view(), am, 0);
+        c[size - k] = -trace(am) / static_cast<T>(k);
+    }
+    return c;
 }
 
 // Increment and decrement operators
 
-SquareMat& SquareMat::operator++() {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator++() {
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
-            ++matrix[i][j];
+            ++buffer[i * stride + j];
         }
     }
     return *this;
 }
 
-SquareMat SquareMat::operator++(int) {
-    SquareMat temp = *this;
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator++(int) {
+    BasicSquareMat temp = *this;
     ++(*this);
     return temp;
 }
 
-SquareMat& SquareMat::operator--() {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator--() {
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
-            --matrix[i][j];
+            --buffer[i * stride + j];
         }
     }
     return *this;
 }
 
-SquareMat SquareMat::operator--(int) {
-    SquareMat temp = *this;
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator--(int) {
+    BasicSquareMat temp = *this;
     --(*this);
     return temp;
 }
 
 // Matrix operations
 
-SquareMat SquareMat::operator~() const {
-    SquareMat result(size);
-    for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            result.matrix[i][j] = matrix[j][i];
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::operator~() const {
+    return transpose(view(), resource);
+}
+
+template <typename T>
+T BasicSquareMat<T>::operator!() const {
+    return determinant(view());
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMat<T>::transpose(MatrixView<const T> source, std::pmr::memory_resource* resource) {
+    int n = source.dimension();
+    BasicSquareMat result(n, resource);
+    T* dst = result.elements();
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            dst[i * result.stride + j] = source.row(j)[i];
         }
     }
     return result;
 }
 
-double SquareMat::operator!() const {
-    return determinantHelper(matrix, size);
+template <typename T>
+T BasicSquareMat<T>::determinant(MatrixView<const T> source) {
+    int n = source.dimension();
+    // Rows and columns still available to the expansion; the minors are never copied
+    std::vector<int> rows(n);
+    std::vector<int> cols(n);
+    for (int j = 0; j < n; ++j) {
+        rows[j] = j;
+        cols[j] = j;
+    }
+    return determinantHelper(source.data(), source.leadingDimension(), rows.data(), cols.data(), n);
+}
+
+template <typename T>
+T BasicSquareMat<T>::determinant(MinorView<const T> source) {
+    int n = source.dimension();
+    std::vector<int> rows(n);
+    std::vector<int> cols(n);
+    for (int j = 0; j < n; ++j) {
+        rows[j] = j + (j >= source.skippedRow());
+        cols[j] = j + (j >= source.skippedColumn());
+    }
+    MatrixView<const T> parent = source.parent();
+    return determinantHelper(parent.data(), parent.leadingDimension(), rows.data(), cols.data(), n);
 }
 
 // Comparison operators
 
-bool SquareMat::operator==(const SquareMat& other) const {
+template <typename T>
+bool BasicSquareMat<T>::operator==(const BasicSquareMat& other) const {
     return sum() == other.sum();
 }
 
-bool SquareMat::operator!=(const SquareMat& other) const {
+template <typename T>
+bool BasicSquareMat<T>::operator!=(const BasicSquareMat& other) const {
     return sum() != other.sum();
 }
 
-bool SquareMat::operator<(const SquareMat& other) const {
+template <typename T>
+bool BasicSquareMat<T>::operator<(const BasicSquareMat& other) const {
     return sum() < other.sum();
 }
 
-bool SquareMat::operator>(const SquareMat& other) const {
+template <typename T>
+bool BasicSquareMat<T>::operator>(const BasicSquareMat& other) const {
     return sum() > other.sum();
 }
 
-bool SquareMat::operator<=(const SquareMat& other) const {
+template <typename T>
+bool BasicSquareMat<T>::operator<=(const BasicSquareMat& other) const {
     return sum() <= other.sum();
 }
 
-bool SquareMat::operator>=(const SquareMat& other) const {
+template <typename T>
+bool BasicSquareMat<T>::operator>=(const BasicSquareMat& other) const {
     return sum() >= other.sum();
 }
 
 // Compound assignment operators
 
-SquareMat& SquareMat::operator+=(const SquareMat& other) {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator+=(const BasicSquareMat& other) {
+    return *this += other.view();
+}
+
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator+=(MatrixView<const T> other) {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for +=");
     }
     
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] += other.matrix[i][j];
-        }
+        addRow(buffer + i * stride, other.row(i), buffer + i * stride, size);
     }
     
     return *this;
 }
 
-SquareMat& SquareMat::operator-=(const SquareMat& other) {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator-=(const BasicSquareMat& other) {
+    return *this -= other.view();
+}
+
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator-=(MatrixView<const T> other) {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for -=");
     }
     
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] -= other.matrix[i][j];
-        }
+        subtractRow(buffer + i * stride, other.row(i), buffer + i * stride, size);
     }
     
     return *this;
 }
 
-SquareMat& SquareMat::operator*=(const SquareMat& other) {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator*=(const BasicSquareMat& other) {
+    return *this *= other.view();
+}
+
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator*=(MatrixView<const T> other) {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for *=");
     }
     
-    // Create temporary matrix to store result
-    SquareMat temp = *this * other;
-    
-    // Copy result back to this matrix
-    for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] = temp.matrix[i][j];
-        }
-    }
+    // The product cannot be formed in place, so build it aside and take its buffer
+    *this = *this * other;
     
     return *this;
 }
 
-SquareMat& SquareMat::operator*=(double scalar) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator*=(T scalar) {
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] = matrix[i][j] * scalar;
-        }
+        scaleRow(buffer + i * stride, scalar, buffer + i * stride, size);
     }
     
     return *this;
 }
 
-SquareMat& SquareMat::operator%=(const SquareMat& other) {
-    if (size != other.size) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator%=(const BasicSquareMat& other) {
+    return *this %= other.view();
+}
+
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator%=(MatrixView<const T> other) {
+    if (size != other.dimension()) {
         throw std::invalid_argument("Matrix sizes do not match for %=");
     }
     
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] *= other.matrix[i][j];
-        }
+        multiplyRow(buffer + i * stride, other.row(i), buffer + i * stride, size);
     }
     
     return *this;
 }
 
-SquareMat& SquareMat::operator%=(int scalar) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator%=(int scalar) {
     if (scalar <= 0) {
         throw std::invalid_argument("Cannot perform modulo by zero or negative number");
     }
     
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
-            matrix[i][j] = modulo(matrix[i][j], scalar);
+            buffer[i * stride + j] = modulo(buffer[i * stride + j], scalar);
         }
     }
     
     return *this;
 }
 
-SquareMat& SquareMat::operator/=(double scalar) {
-    if (scalar == 0.0) {
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::operator/=(T scalar) {
+    if (scalar == T()) {
         throw std::invalid_argument("Cannot divide by zero");
     }
     
+    T* buffer = elements();
     for (int i = 0; i < size; ++i) {
-        for (int j = 0; j < size; ++j) {
-            matrix[i][j] /= scalar;
-        }
+        divideRow(buffer + i * stride, scalar, buffer + i * stride, size);
     }
     
     return *this;
 }
 
-// Stream output operator
-
-std::ostream& operator<<(std::ostream& os, const SquareMat& mat) {
-    for (int i = 0; i < mat.size; ++i) {
-        os << "| " <<" ";
-        for (int j = 0; j < mat.size; ++j) {
-            os << mat.matrix[i][j]<<" ";
+template <typename T>
+BasicSquareMat<T>& BasicSquareMat<T>::gemm(T alpha, MatrixView<const T> a, MatrixView<const T> b, T beta) {
+    if (size != a.dimension() || size != b.dimension()) {
+        throw std::invalid_argument("Matrix sizes do not match for gemm");
+    }
+    
+    if (overlaps(a) || overlaps(b)) {
+        // The engine cannot read operands it is writing to, so form the product aside
+        BasicSquareMat product(size, resource);
+        gemm::multiply(size, alpha, a.data(), a.leadingDimension(), b.data(), b.leadingDimension(),
+                       T(), product.elements(), product.stride);
+        T* buffer = elements();
+        const T* computed = product.elements();
+        for (int i = 0; i < size; ++i) {
+            T* row = buffer + i * stride;
+            const T* p = computed + i * stride;
+            for (int j = 0; j < size; ++j) {
+                row[j] = (beta == T()) ? p[j] : p[j] + beta * row[j];
+            }
         }
-        os << " |" << std::endl;
+        return *this;
     }
-    return os;
+    
+    gemm::multiply(size, alpha, a.data(), a.leadingDimension(), b.data(), b.leadingDimension(),
+                   beta, elements(), stride);
+    
+    return *this;
 }
 
+// Explicit instantiations for the supported element types
+
+template class BasicSquareMat<float>;
+template class BasicSquareMat<double>;
+template class BasicSquareMat<std::int32_t>;
+template class BasicSquareMat<std::int64_t>;
+
 } // namespace matrix_ops
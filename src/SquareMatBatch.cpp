@@ -0,0 +1,355 @@
+// idocohen963@gmail.com
+
+#include "../include/SquareMatBatch.hpp"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace matrix_ops {
+
+namespace {
+
+// Lane kernels: planes are a whole number of cache lines, so the loops run in fixed
+// chunks of one line through restrict-qualified pointers; with a constant trip count
+// and no aliasing, the compiler vectorizes them without runtime checks or remainders
+
+template <typename T>
+constexpr int LINE = BasicSquareMatBatch<T>::LANES;
+
+constexpr int SLICE = 256;  ///< Matrices per slice in batched products (a multiple of every LANES)
+
+template <typename T>
+void addLanes(int pitch, const T* __restrict__ a, const T* __restrict__ b, T* __restrict__ r) {
+    for (int line = 0; line < pitch; line += LINE<T>) {
+        for (int k = line; k < line + LINE<T>; ++k) {
+            r[k] = a[k] + b[k];
+        }
+    }
+}
+
+template <typename T>
+void multiplyLanes(int pitch, const T* __restrict__ a, const T* __restrict__ b, T* __restrict__ r) {
+    for (int line = 0; line < pitch; line += LINE<T>) {
+        for (int k = line; k < line + LINE<T>; ++k) {
+            r[k] = a[k] * b[k];
+        }
+    }
+}
+
+template <typename T>
+void multiplyAddLanes(int pitch, const T* __restrict__ a, const T* __restrict__ b, T* __restrict__ r) {
+    for (int line = 0; line < pitch; line += LINE<T>) {
+        for (int k = line; k < line + LINE<T>; ++k) {
+            r[k] += a[k] * b[k];
+        }
+    }
+}
+
+template <typename T>
+void determinant2Lanes(int pitch, const T* __restrict__ a, const T* __restrict__ b, const T* __restrict__ c,
+                       const T* __restrict__ d, T* __restrict__ r) {
+    for (int line = 0; line < pitch; line += LINE<T>) {
+        for (int k = line; k < line + LINE<T>; ++k) {
+            r[k] = a[k] * d[k] - b[k] * c[k];
+        }
+    }
+}
+
+} // namespace
+
+// Private helper methods
+
+template <typename T>
+void BasicSquareMatBatch<T>::acquireStorage(int n, int count) {
+    size = n;
+    matrices = count;
+    pitch = (count + LANES - 1) / LANES * LANES;
+    values = static_cast<T*>(resource->allocate(static_cast<std::size_t>(n) * n * pitch * sizeof(T), ALIGNMENT));
+}
+
+template <typename T>
+BasicSquareMatBatch<T>::BasicSquareMatBatch(int size, int count, std::pmr::memory_resource* resource, Uninitialized)
+    : values(nullptr), size(0), matrices(0), pitch(0), resource(resource) {
+    acquireStorage(size, count);
+}
+
+template <typename T>
+void BasicSquareMatBatch<T>::releaseStorage() {
+    if (values != nullptr) {
+        resource->deallocate(values, static_cast<std::size_t>(size) * size * pitch * sizeof(T), ALIGNMENT);
+        values = nullptr;
+    }
+}
+
+template <typename T>
+void BasicSquareMatBatch<T>::requireSameShape(const BasicSquareMatBatch& other, const char* operation) const {
+    if (size != other.size || matrices != other.matrices) {
+        throw std::invalid_argument(std::string("Batch shapes do not match for ") + operation);
+    }
+}
+
+// Constructors and destructor
+
+template <typename T>
+BasicSquareMatBatch<T>::BasicSquareMatBatch(int size, int count, std::pmr::memory_resource* resource)
+    : values(nullptr), size(0), matrices(0), pitch(0), resource(resource) {
+    if (size <= 0) {
+        throw std::length_error("Matrix size must be positive");
+    }
+    if (count <= 0) {
+        throw std::length_error("Batch count must be positive");
+    }
+    if (resource == nullptr) {
+        throw std::invalid_argument("Memory resource cannot be null");
+    }
+
+    acquireStorage(size, count);
+    std::fill(values, values + static_cast<std::size_t>(size) * size * pitch, T());
+}
+
+template <typename T>
+BasicSquareMatBatch<T>::BasicSquareMatBatch(const BasicSquareMatBatch& other)
+    : values(nullptr), size(0), matrices(0), pitch(0), resource(other.resource) {
+    if (other.values != nullptr) {
+        acquireStorage(other.size, other.matrices);
+        std::copy(other.values, other.values + static_cast<std::size_t>(size) * size * pitch, values);
+    }
+}
+
+template <typename T>
+BasicSquareMatBatch<T>::BasicSquareMatBatch(BasicSquareMatBatch&& other) noexcept
+    : values(other.values), size(other.size), matrices(other.matrices), pitch(other.pitch),
+      resource(other.resource) {
+    other.values = nullptr;
+    other.size = 0;
+    other.matrices = 0;
+    other.pitch = 0;
+}
+
+template <typename T>
+BasicSquareMatBatch<T>::~BasicSquareMatBatch() {
+    releaseStorage();
+}
+
+// Assignment operators
+
+template <typename T>
+BasicSquareMatBatch<T>& BasicSquareMatBatch<T>::operator=(const BasicSquareMatBatch& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    if (other.values == nullptr) {
+        releaseStorage();
+        size = 0;
+        matrices = 0;
+        pitch = 0;
+        return *this;
+    }
+    // Copy into this batch's own resource, then take the copy over in O(1)
+    BasicSquareMatBatch copy(other.size, other.matrices, resource, Uninitialized());
+    std::copy(other.values, other.values + static_cast<std::size_t>(other.size) * other.size * other.pitch,
+              copy.values);
+    *this = std::move(copy);
+    return *this;
+}
+
+template <typename T>
+BasicSquareMatBatch<T>& BasicSquareMatBatch<T>::operator=(BasicSquareMatBatch&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    // A buffer from another resource may not outlive that resource; copy it into ours instead
+    if (*resource != *other.resource) {
+        return *this = static_cast<const BasicSquareMatBatch&>(other);
+    }
+
+    releaseStorage();
+    values = other.values;
+    size = other.size;
+    matrices = other.matrices;
+    pitch = other.pitch;
+    other.values = nullptr;
+    other.size = 0;
+    other.matrices = 0;
+    other.pitch = 0;
+
+    return *this;
+}
+
+// Access
+
+template <typename T>
+T& BasicSquareMatBatch<T>::operator()(int index, int row, int col) {
+    const BasicSquareMatBatch& self = *this;
+    return const_cast<T&>(self(index, row, col));
+}
+
+template <typename T>
+const T& BasicSquareMatBatch<T>::operator()(int index, int row, int col) const {
+    if (index < 0 || index >= matrices) {
+        throw std::out_of_range("Batch index out of range");
+    }
+    if (row < 0 || row >= size) {
+        throw std::out_of_range("Row index out of range");
+    }
+    if (col < 0 || col >= size) {
+        throw std::out_of_range("Column index out of range");
+    }
+    return plane(row, col)[index];
+}
+
+template <typename T>
+BasicSquareMat<T> BasicSquareMatBatch<T>::get(int index) const {
+    if (index < 0 || index >= matrices) {
+        throw std::out_of_range("Batch index out of range");
+    }
+
+    BasicSquareMat<T> result(size, resource);
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            result[i][j] = plane(i, j)[index];
+        }
+    }
+    return result;
+}
+
+template <typename T>
+void BasicSquareMatBatch<T>::set(int index, const BasicSquareMat<T>& mat) {
+    if (index < 0 || index >= matrices) {
+        throw std::out_of_range("Batch index out of range");
+    }
+    if (mat.dimension() != size) {
+        throw std::invalid_argument("Matrix size does not match the batch");
+    }
+
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            plane(i, j)[index] = mat[i][j];
+        }
+    }
+}
+
+// Batched operators
+
+template <typename T>
+BasicSquareMatBatch<T> BasicSquareMatBatch<T>::operator*(const BasicSquareMatBatch& other) const {
+    requireSameShape(other, "multiplication");
+
+    BasicSquareMatBatch result(size, matrices, resource, Uninitialized());
+    // Work on a slice of the batch at a time so that the slices of all
+    // operand planes stay in L1 while every product element is formed
+    for (int k = 0; k < pitch; k += SLICE) {
+        int width = std::min(SLICE, pitch - k);
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                T* r = result.plane(i, j) + k;
+                multiplyLanes(width, plane(i, 0) + k, other.plane(0, j) + k, r);
+                for (int l = 1; l < size; ++l) {
+                    multiplyAddLanes(width, plane(i, l) + k, other.plane(l, j) + k, r);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+template <typename T>
+BasicSquareMatBatch<T> BasicSquareMatBatch<T>::operator+(const BasicSquareMatBatch& other) const {
+    requireSameShape(other, "addition");
+
+    BasicSquareMatBatch result(size, matrices, resource, Uninitialized());
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            addLanes(pitch, plane(i, j), other.plane(i, j), result.plane(i, j));
+        }
+    }
+    return result;
+}
+
+template <typename T>
+BasicSquareMatBatch<T> BasicSquareMatBatch<T>::operator~() const {
+    BasicSquareMatBatch result(size, matrices, resource, Uninitialized());
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            std::copy(plane(j, i), plane(j, i) + pitch, result.plane(i, j));
+        }
+    }
+    return result;
+}
+
+template <typename T>
+BasicVector<T> BasicSquareMatBatch<T>::operator!() const {
+    if (matrices == 0) {
+        throw std::length_error("Cannot take determinants of an empty batch");
+    }
+
+    BasicVector<T> result(matrices, resource);
+    T* det = result.data();
+    if (size > 4) {
+        for (int k = 0; k < matrices; ++k) {
+            det[k] = !get(k);
+        }
+        return result;
+    }
+    if (size == 1) {
+        std::copy(plane(0, 0), plane(0, 0) + matrices, det);
+        return result;
+    }
+
+    // Expand along the first two rows (Laplace): every 2x2 minor of rows 0-1
+    // times its complementary minor of rows 2-3, each minor formed across the batch
+    std::vector<T> minors(12 * static_cast<std::size_t>(pitch));
+    auto minor = [&](int slot) { return minors.data() + slot * pitch; };
+    if (size == 2) {
+        determinant2Lanes(pitch, plane(0, 0), plane(0, 1), plane(1, 0), plane(1, 1), minor(0));
+        std::copy(minor(0), minor(0) + matrices, det);
+        return result;
+    }
+    if (size == 3) {
+        // Minors of rows 1-2 for columns (1,2), (0,2), (0,1)
+        determinant2Lanes(pitch, plane(1, 1), plane(1, 2), plane(2, 1), plane(2, 2), minor(0));
+        determinant2Lanes(pitch, plane(1, 0), plane(1, 2), plane(2, 0), plane(2, 2), minor(1));
+        determinant2Lanes(pitch, plane(1, 0), plane(1, 1), plane(2, 0), plane(2, 1), minor(2));
+        const T* a0 = plane(0, 0);
+        const T* a1 = plane(0, 1);
+        const T* a2 = plane(0, 2);
+        const T* m0 = minor(0);
+        const T* m1 = minor(1);
+        const T* m2 = minor(2);
+        for (int k = 0; k < matrices; ++k) {
+            det[k] = a0[k] * m0[k] - a1[k] * m1[k] + a2[k] * m2[k];
+        }
+        return result;
+    }
+
+    static constexpr int PAIRS[6][2] = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+    for (int p = 0; p < 6; ++p) {
+        int c0 = PAIRS[p][0];
+        int c1 = PAIRS[p][1];
+        determinant2Lanes(pitch, plane(0, c0), plane(0, c1), plane(1, c0), plane(1, c1), minor(p));
+        determinant2Lanes(pitch, plane(2, c0), plane(2, c1), plane(3, c0), plane(3, c1), minor(6 + p));
+    }
+    // Pair p of the top rows is complementary to pair 5 - p of the bottom rows
+    const T* top[6];
+    const T* bottom[6];
+    for (int p = 0; p < 6; ++p) {
+        top[p] = minor(p);
+        bottom[p] = minor(6 + 5 - p);
+    }
+    for (int k = 0; k < matrices; ++k) {
+        det[k] = top[0][k] * bottom[0][k] - top[1][k] * bottom[1][k] + top[2][k] * bottom[2][k]
+               + top[3][k] * bottom[3][k] - top[4][k] * bottom[4][k] + top[5][k] * bottom[5][k];
+    }
+    return result;
+}
+
+// Explicit instantiations for the supported element types
+
+template class BasicSquareMatBatch<float>;
+template class BasicSquareMatBatch<double>;
+template class BasicSquareMatBatch<std::int32_t>;
+template class BasicSquareMatBatch<std::int64_t>;
+
+} // namespace matrix_ops
@@ -0,0 +1,132 @@
+// idocohen963@gmail.com
+
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace matrix_ops {
+
+namespace {
+
+// Set on pool workers so nested parallelFor calls run inline
+thread_local bool insideWorker = false;
+
+} // namespace
+
+/**
+ * @brief State of one parallelFor call, shared by the caller and its helpers
+ */
+struct ThreadPool::Job {
+    const std::function<void(int)>* body;
+    int count;
+    std::atomic<int> next{0};    ///< Next unclaimed task index
+    int active = 0;              ///< Helpers currently running tasks (guarded by the pool mutex)
+    std::condition_variable finished;
+    std::exception_ptr error;    ///< First exception thrown by a task
+    std::mutex errorMutex;
+};
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+int ThreadPool::hardwareThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::workerCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(workers.size());
+}
+
+void ThreadPool::ensureWorkers(int count) {
+    // Called with the mutex held
+    while (static_cast<int>(workers.size()) < count) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+void ThreadPool::runTasks(Job& job) {
+    for (int task = job.next++; task < job.count; task = job.next++) {
+        try {
+            (*job.body)(task);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.errorMutex);
+            if (!job.error) {
+                job.error = std::current_exception();
+            }
+            job.next = job.count;
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    insideWorker = true;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (stopping) {
+            return;
+        }
+        Job* job = queue.front();
+        queue.pop_front();
+        ++job->active;
+        lock.unlock();
+
+        runTasks(*job);
+
+        lock.lock();
+        if (--job->active == 0) {
+            job->finished.notify_all();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(int count, int threads, const std::function<void(int)>& body) {
+    threads = std::min(threads, count);
+    if (threads <= 1 || insideWorker) {
+        for (int task = 0; task < count; ++task) {
+            body(task);
+        }
+        return;
+    }
+
+    Job job;
+    job.body = &body;
+    job.count = count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ensureWorkers(threads - 1);
+        for (int i = 1; i < threads; ++i) {
+            queue.push_back(&job);
+        }
+    }
+    wake.notify_all();
+
+    runTasks(job);
+
+    // Withdraw helper slots nobody claimed, then wait for the helpers that did
+    std::unique_lock<std::mutex> lock(mutex);
+    queue.erase(std::remove(queue.begin(), queue.end(), &job), queue.end());
+    job.finished.wait(lock, [&job] { return job.active == 0; });
+    lock.unlock();
+
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+} // namespace matrix_ops
@@ -0,0 +1,318 @@
+// idocohen963@gmail.com
+
+#include "../include/Vector.hpp"
+#include "../include/Gemv.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace matrix_ops {
+
+// Private helper methods
+
+template <typename T>
+void BasicVector<T>::acquireStorage(int n) {
+    size = n;
+    values = static_cast<T*>(resource->allocate(n * sizeof(T), ALIGNMENT));
+    std::fill(values, values + n, T());
+}
+
+template <typename T>
+void BasicVector<T>::releaseStorage() {
+    if (values != nullptr) {
+        resource->deallocate(values, size * sizeof(T), ALIGNMENT);
+        values = nullptr;
+    }
+}
+
+// Constructors and destructor
+
+template <typename T>
+BasicVector<T>::BasicVector(int size, std::pmr::memory_resource* resource)
+    : values(nullptr), size(0), resource(resource) {
+    if (size <= 0) {
+        throw std::length_error("Vector size must be positive");
+    }
+    if (resource == nullptr) {
+        throw std::invalid_argument("Memory resource cannot be null");
+    }
+
+    acquireStorage(size);
+}
+
+template <typename T>
+BasicVector<T>::BasicVector(const BasicVector& other) : values(nullptr), size(0), resource(other.resource) {
+    if (other.size > 0) {
+        acquireStorage(other.size);
+        std::copy(other.values, other.values + size, values);
+    }
+}
+
+template <typename T>
+BasicVector<T>::BasicVector(BasicVector&& other) noexcept
+    : values(other.values), size(other.size), resource(other.resource) {
+    other.values = nullptr;
+    other.size = 0;
+}
+
+template <typename T>
+BasicVector<T>::~BasicVector() {
+    releaseStorage();
+}
+
+// Assignment operators
+
+template <typename T>
+BasicVector<T>& BasicVector<T>::operator=(const BasicVector& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    // Reuse the existing buffer when the lengths already match
+    if (size != other.size) {
+        T* fresh = (other.size > 0) ? static_cast<T*>(resource->allocate(other.size * sizeof(T), ALIGNMENT)) : nullptr;
+        releaseStorage();
+        values = fresh;
+        size = other.size;
+    }
+    std::copy(other.values, other.values + size, values);
+
+    return *this;
+}
+
+template <typename T>
+BasicVector<T>& BasicVector<T>::operator=(BasicVector&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    // A buffer from another resource may not outlive that resource; copy it into ours instead
+    if (*resource != *other.resource) {
+        return *this = static_cast<const BasicVector&>(other);
+    }
+
+    releaseStorage();
+    values = other.values;
+    size = other.size;
+    other.values = nullptr;
+    other.size = 0;
+
+    return *this;
+}
+
+// Access operators
+
+template <typename T>
+T& BasicVector<T>::operator[](int index) {
+    if (index < 0 || index >= size) {
+        throw std::out_of_range("Vector index out of range");
+    }
+    return values[index];
+}
+
+template <typename T>
+const T& BasicVector<T>::operator[](int index) const {
+    if (index < 0 || index >= size) {
+        throw std::out_of_range("Vector index out of range");
+    }
+    return values[index];
+}
+
+// Arithmetic operators
+
+template <typename T>
+BasicVector<T> BasicVector<T>::operator+(const BasicVector& other) const {
+    if (size != other.size) {
+        throw std::invalid_argument("Vector sizes do not match for addition");
+    }
+
+    BasicVector result(*this);
+    gemv::axpy(size, T(1), other.values, result.values);
+    return result;
+}
+
+template <typename T>
+BasicVector<T> BasicVector<T>::operator-(const BasicVector& other) const {
+    if (size != other.size) {
+        throw std::invalid_argument("Vector sizes do not match for subtraction");
+    }
+
+    BasicVector result(*this);
+    gemv::axpy(size, T(-1), other.values, result.values);
+    return result;
+}
+
+template <typename T>
+BasicVector<T> BasicVector<T>::operator*(T scalar) const {
+    BasicVector result(size, resource);
+    for (int i = 0; i < size; ++i) {
+        result.values[i] = values[i] * scalar;
+    }
+    return result;
+}
+
+template <typename T>
+T BasicVector<T>::dot(const BasicVector& other) const {
+    if (size != other.size) {
+        throw std::invalid_argument("Vector sizes do not match for dot product");
+    }
+
+    return gemv::dot(size, values, other.values);
+}
+
+template <typename T>
+BasicVector<T>& BasicVector<T>::axpy(T alpha, const BasicVector& x) {
+    if (size != x.size) {
+        throw std::invalid_argument("Vector sizes do not match for axpy");
+    }
+
+    gemv::axpy(size, alpha, x.values, values);
+    return *this;
+}
+
+// Comparison operators
+
+template <typename T>
+bool BasicVector<T>::operator==(const BasicVector& other) const {
+    return size == other.size && std::equal(values, values + size, other.values);
+}
+
+template <typename T>
+bool BasicVector<T>::operator!=(const BasicVector& other) const {
+    return !(*this == other);
+}
+
+// Matrix-vector products
+
+template <typename T>
+BasicVector<T> operator*(const BasicSquareMat<T>& mat, const BasicVector<T>& vec) {
+    if (mat.dimension() != vec.dimension()) {
+        throw std::invalid_argument("Matrix and vector sizes do not match for multiplication");
+    }
+
+    MatrixView<const T> a = mat.view();
+    BasicVector<T> result(vec.dimension(), mat.memoryResource());
+    gemv::multiply(a.dimension(), T(1), a.data(), a.leadingDimension(), vec.data(), T(), result.data());
+    return result;
+}
+
+template <typename T>
+BasicVector<T> operator*(const BasicVector<T>& vec, const BasicSquareMat<T>& mat) {
+    if (mat.dimension() != vec.dimension()) {
+        throw std::invalid_argument("Vector and matrix sizes do not match for multiplication");
+    }
+
+    MatrixView<const T> a = mat.view();
+    BasicVector<T> result(vec.dimension(), mat.memoryResource());
+    gemv::multiplyTransposed(a.dimension(), T(1), a.data(), a.leadingDimension(), vec.data(), T(), result.data());
+    return result;
+}
+
+bool preferRepeatedProducts(int size, std::uint64_t power, int vectors) {
+    if (power < 2) {
+        return true;
+    }
+    const double squarings = 63 - __builtin_clzll(power);
+    const double applied = __builtin_popcountll(power);
+    const double repeated = static_cast<double>(power) * vectors;
+    return repeated <= squarings * size / MATRIX_PRODUCT_SPEEDUP + applied * vectors;
+}
+
+namespace {
+
+// Replace every vector x of block by mat^power * x; block already holds the caller's copies
+template <typename T>
+void applyPower(const BasicSquareMat<T>& mat, std::uint64_t power, std::vector<BasicVector<T>>& block, int threads) {
+    if (threads < 0) {
+        throw std::invalid_argument("Thread count cannot be negative");
+    }
+    const int n = mat.dimension();
+    for (const BasicVector<T>& vec : block) {
+        if (vec.dimension() != n) {
+            throw std::invalid_argument("Matrix and vector sizes do not match for multiplication");
+        }
+    }
+
+    if (block.empty() || power == 0) {
+        return;
+    }
+    BasicVector<T> scratch(n, mat.memoryResource());
+    // x = M * x for every vector of the block, through scratch
+    auto apply = [&](MatrixView<const T> m) {
+        for (BasicVector<T>& vec : block) {
+            gemv::multiply(n, T(1), m.data(), m.leadingDimension(), vec.data(), T(), scratch.data(), threads);
+            std::swap(vec, scratch);
+        }
+    };
+
+    if (preferRepeatedProducts(n, power, static_cast<int>(block.size()))) {
+        for (std::uint64_t step = 0; step < power; ++step) {
+            apply(mat.view());
+        }
+        return;
+    }
+
+    // The squarings A^(2^i) commute, so each can be applied as soon as it is formed
+    BasicSquareMat<T> square = mat;
+    for (std::uint64_t p = power; p != 0; p >>= 1) {
+        if (p & 1u) {
+            apply(square.view());
+        }
+        if (p > 1) {
+            square = square.multiply(square.view(), threads);
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+BasicVector<T> powerTimes(const BasicSquareMat<T>& mat, std::uint64_t power, const BasicVector<T>& vec,
+                          int threads) {
+    std::vector<BasicVector<T>> block;
+    block.push_back(vec);
+    applyPower(mat, power, block, threads);
+    return std::move(block.front());
+}
+
+template <typename T>
+std::vector<BasicVector<T>> powerTimes(const BasicSquareMat<T>& mat, std::uint64_t power,
+                                       const std::vector<BasicVector<T>>& block, int threads) {
+    std::vector<BasicVector<T>> result(block);
+    applyPower(mat, power, result, threads);
+    return result;
+}
+
+// Explicit instantiations for the supported element types
+
+template class BasicVector<float>;
+template class BasicVector<double>;
+template class BasicVector<std::int32_t>;
+template class BasicVector<std::int64_t>;
+
+template BasicVector<float> operator*(const BasicSquareMat<float>&, const BasicVector<float>&);
+template BasicVector<double> operator*(const BasicSquareMat<double>&, const BasicVector<double>&);
+template BasicVector<std::int32_t> operator*(const BasicSquareMat<std::int32_t>&, const BasicVector<std::int32_t>&);
+template BasicVector<std::int64_t> operator*(const BasicSquareMat<std::int64_t>&, const BasicVector<std::int64_t>&);
+
+template BasicVector<float> operator*(const BasicVector<float>&, const BasicSquareMat<float>&);
+template BasicVector<double> operator*(const BasicVector<double>&, const BasicSquareMat<double>&);
+template BasicVector<std::int32_t> operator*(const BasicVector<std::int32_t>&, const BasicSquareMat<std::int32_t>&);
+template BasicVector<std::int64_t> operator*(const BasicVector<std::int64_t>&, const BasicSquareMat<std::int64_t>&);
+
+
+template BasicVector<float> powerTimes(const BasicSquareMat<float>&, std::uint64_t, const BasicVector<float>&, int);
+template BasicVector<double> powerTimes(const BasicSquareMat<double>&, std::uint64_t, const BasicVector<double>&, int);
+template BasicVector<std::int32_t> powerTimes(const BasicSquareMat<std::int32_t>&, std::uint64_t,
+                                              const BasicVector<std::int32_t>&, int);
+template BasicVector<std::int64_t> powerTimes(const BasicSquareMat<std::int64_t>&, std::uint64_t,
+                                              const BasicVector<std::int64_t>&, int);
+
+template std::vector<BasicVector<float>> powerTimes(const BasicSquareMat<float>&, std::uint64_t,
+                                                    const std::vector<BasicVector<float>>&, int);
+template std::vector<BasicVector<double>> powerTimes(const BasicSquareMat<double>&, std::uint64_t,
+                                                     const std::vector<BasicVector<double>>&, int);
+template std::vector<BasicVector<std::int32_t>> powerTimes(const BasicSquareMat<std::int32_t>&, std::uint64_t,
+                                                           const std::vector<BasicVector<std::int32_t>>&, int);
+template std::vector<BasicVector<std::int64_t>> powerTimes(const BasicSquareMat<std::int64_t>&, std::uint64_t,
+                                                           const std::vector<BasicVector<std::int64_t>>&, int);
+
+} // namespace matrix_ops
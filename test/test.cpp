@@ -2,13 +2,128 @@
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../include/SquareMat.hpp"
+#include "../include/Autotune.hpp"
+#include "../include/BufferPool.hpp"
+#include "../include/FixedSquareMat.hpp"
+#include "../include/Gemm.hpp"
+#include "../include/Gemv.hpp"
+#include "../include/Modular.hpp"
+#include "../include/PowerCache.hpp"
+#include "../include/Simd.hpp"
+#include "../include/SquareMatBatch.hpp"
+#include "../include/ThreadPool.hpp"
+#include "../include/Vector.hpp"
 #include "doctest.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace matrix_ops;
 using namespace doctest;
 
+/**
+ * @brief Compare two matrices element by element (operator== compares element sums)
+ */
+template <typename T>
+bool sameElements(const BasicSquareMat<T>& a, const BasicSquareMat<T>& b) {
+    if (a.dimension() != b.dimension()) {
+        return false;
+    }
+    for (int i = 0; i < a.dimension(); ++i) {
+        for (int j = 0; j < a.dimension(); ++j) {
+            if (a[i][j] != b[i][j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Largest absolute elementwise difference between two matrices of the same size
+ */
+template <typename T>
+double maxDifference(const BasicSquareMat<T>& a, const BasicSquareMat<T>& b) {
+    double worst = 0.0;
+    for (int i = 0; i < a.dimension(); ++i) {
+        for (int j = 0; j < a.dimension(); ++j) {
+            worst = std::max(worst, std::fabs(static_cast<double>(a[i][j]) - static_cast<double>(b[i][j])));
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief Reference product with the textbook triple loop
+ */
+template <typename T>
+BasicSquareMat<T> naiveProduct(const BasicSquareMat<T>& a, const BasicSquareMat<T>& b) {
+    int n = a.dimension();
+    BasicSquareMat<T> result(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            T sum = T();
+            for (int k = 0; k < n; ++k) {
+                sum += a[i][k] * b[k][j];
+            }
+            result[i][j] = sum;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Fill a matrix with small deterministic pseudo-random values
+ */
+template <typename T>
+BasicSquareMat<T> patternMatrix(int n, int seed) {
+    BasicSquareMat<T> m(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            m[i][j] = static_cast<T>((i * 7 + j * 13 + seed * 31) % 19 - 9);
+        }
+    }
+    return m;
+}
+
+/**
+ * @brief Saves the process-wide GEMM and SIMD settings and restores them on scope exit
+ *
+ * Tests that change block sizes, thread count, algorithm or instruction set hold
+ * one, so the settings (including a profile loaded from SQUAREMAT_GEMM_PROFILE)
+ * come back even when a REQUIRE or an exception leaves the test early.
+ */
+class GemmSettingsGuard {
+private:
+    gemm::BlockSizes blocks = gemm::blockSizes();
+    int threads = gemm::threadCount();
+    gemm::Algorithm algorithm = gemm::algorithm();
+    int crossover = gemm::strassenCrossover();
+    simd::Isa isa = simd::activeIsa();
+
+public:
+    GemmSettingsGuard() = default;
+    GemmSettingsGuard(const GemmSettingsGuard&) = delete;
+    GemmSettingsGuard& operator=(const GemmSettingsGuard&) = delete;
+
+    ~GemmSettingsGuard() {
+        gemm::setBlockSizes(blocks);
+        gemm::setThreadCount(threads);
+        gemm::setAlgorithm(algorithm);
+        gemm::setStrassenCrossover(crossover);
+        simd::setActiveIsa(isa);
+    }
+};
+
 TEST_CASE("operator[]") {
     SUBCASE("const matrix") {
         const SquareMat m(2);
@@ -56,6 +171,21 @@ TEST_CASE("Constructor and basic operations") {
         CHECK(m2[0][0] == 1.0);
     }
     
+    SUBCASE("Move constructor steals the buffer") {
+        SquareMat m1(2);
+        m1[0][0] = 1.0;
+        m1[1][1] = 4.0;
+        
+        SquareMat m2(std::move(m1));
+        CHECK(m2[0][0] == 1.0);
+        CHECK(m2[1][1] == 4.0);
+        
+        // Moved-from matrix is empty but still valid
+        CHECK_THROWS_AS(m1[0][0], std::out_of_range);
+        m1 = m2;
+        CHECK(m1[1][1] == 4.0);
+    }
+    
 }
 
 TEST_CASE("Assignment operators") {
@@ -96,6 +226,245 @@ TEST_CASE("Assignment operators") {
         CHECK(m[1][1] == 4.0);
     }
     
+    SUBCASE("Move assignment takes over the buffer") {
+        SquareMat m1(2);
+        m1[0][1] = 2.0;
+        m1[1][0] = 3.0;
+        
+        SquareMat m2(3);
+        m2 = std::move(m1);
+        
+        CHECK(m2[0][1] == 2.0);
+        CHECK(m2[1][0] == 3.0);
+        CHECK_THROWS_AS(m2[2][2], std::out_of_range);
+        CHECK_THROWS_AS(m1[0][0], std::out_of_range);
+        
+        // Assigning a temporary moves it
+        m2 = m2 + m2;
+        CHECK(m2[0][1] == 4.0);
+    }
+    
+}
+
+/**
+ * @brief Memory resource that counts the allocations it forwards upstream
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    int allocations = 0;
+    int deallocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("Inline storage for small matrices") {
+    BufferPool& pool = BufferPool::local();
+    pool.resetStats();
+    CountingResource counter;
+    
+    SUBCASE("Small matrices never allocate") {
+        {
+            SquareMat m(SquareMat::INLINE_SIZE, &counter);
+            m[3][3] = 4.0;
+            SquareMat p = (m * m) + ~m - (m ^ 3);
+            SquareMat copy = p;
+            CHECK(copy[3][3] == Approx(16.0 + 4.0 - 64.0));
+        }
+        CHECK(counter.allocations == 0);
+        CHECK(pool.stats().misses == 0);
+        CHECK(pool.stats().hits == 0);
+    }
+    
+    SUBCASE("Moving an inline matrix copies its elements") {
+        SquareMat m1(3);
+        m1[2][1] = 7.0;
+        SquareMat m2(std::move(m1));
+        CHECK(m2[2][1] == 7.0);
+        CHECK_THROWS_AS(m1[0][0], std::out_of_range);
+        
+        SquareMat m3(8);
+        m3 = std::move(m2);
+        CHECK(m3[2][1] == 7.0);
+        CHECK_THROWS_AS(m3[3][0], std::out_of_range);
+    }
+    
+    SUBCASE("Switching between inline and heap storage on assignment") {
+        SquareMat small(2);
+        small[1][1] = 3.0;
+        SquareMat big = SquareMat::identity(6);
+        
+        SquareMat m = small;
+        m = big;
+        CHECK(m[5][5] == 1.0);
+        m = small;
+        CHECK(m[1][1] == 3.0);
+        CHECK_THROWS_AS(m[2][2], std::out_of_range);
+    }
+    
+    SUBCASE("Vectors of small matrices") {
+        std::vector<SquareMat> mats;
+        for (int i = 0; i < 100; ++i) {
+            mats.push_back(SquareMat::identity(3) * i);
+        }
+        CHECK(mats[42][1][1] == 42.0);
+        CHECK(mats[99][2][2] == 99.0);
+    }
+}
+
+TEST_CASE("Memory resources") {
+    SUBCASE("Matrices and operator results draw from the given resource") {
+        CountingResource counter;
+        {
+            SquareMat m1(5, &counter);
+            SquareMat m2 = SquareMat::identity(5, &counter);
+            CHECK(m1.memoryResource() == &counter);
+            CHECK(counter.allocations == 2);
+            
+            SquareMat sum = m1 + m2;
+            CHECK(sum.memoryResource() == &counter);
+            CHECK(sum[1][1] == 1.0);
+            
+            SquareMat copy(sum);
+            CHECK(copy.memoryResource() == &counter);
+            CHECK(counter.allocations == 4);
+            
+            SquareMat elsewhere(sum, std::pmr::new_delete_resource());
+            CHECK(elsewhere.memoryResource() == std::pmr::new_delete_resource());
+            CHECK(counter.allocations == 4);
+        }
+        CHECK(counter.deallocations == counter.allocations);
+    }
+    
+    SUBCASE("Move assignment keeps the target's resource") {
+        CountingResource counter;
+        SquareMat longLived(6);
+        {
+            SquareMat m1(6, &counter);
+            m1[5][4] = 3.0;
+            longLived = std::move(m1);
+            CHECK(longLived.memoryResource() == std::pmr::get_default_resource());
+            CHECK(m1.dimension() == 6);  // Different resources: copied, not stolen
+            
+            SquareMat m2(7, &counter);
+            SquareMat m3(7, &counter);
+            m3 = std::move(m2);
+            CHECK(m2.dimension() == 0);  // Same resource: buffer stolen
+        }
+        CHECK(counter.allocations == 3);
+        CHECK(counter.deallocations == 3);
+        CHECK(longLived[5][4] == 3.0);
+        
+        CHECK_THROWS_AS(SquareMat(3, nullptr), std::invalid_argument);
+        CHECK_THROWS_AS(SquareMat(longLived, nullptr), std::invalid_argument);
+    }
+    
+    SUBCASE("Results of a temporary right operand use the left operand's resource") {
+        CountingResource counter;
+        SquareMat a = patternMatrix<double>(6, 1);
+        SquareMat b = patternMatrix<double>(6, 2);
+        auto temporary = [&] { return SquareMat(b, &counter); };
+        SquareMat sum = a + temporary();
+        SquareMat difference = a - temporary();
+        SquareMat hadamard = a % temporary();
+        CHECK(sum.memoryResource() == a.memoryResource());
+        CHECK(difference.memoryResource() == a.memoryResource());
+        CHECK(hadamard.memoryResource() == a.memoryResource());
+        CHECK(sameElements(sum, a + b));
+        CHECK(sameElements(difference, a - b));
+        CHECK(sameElements(hadamard, a % b));
+        CHECK(counter.allocations == 3);
+        CHECK(counter.deallocations == 3);
+        
+        SquareMat onCounter(6, &counter);
+        SquareMat reused = onCounter + SquareMat(b, &counter);  // Equal resources: buffer reused
+        CHECK(reused.memoryResource() == &counter);
+        CHECK(counter.allocations == 5);
+    }
+    
+    SUBCASE("Monotonic arena") {
+        std::pmr::monotonic_buffer_resource arena;
+        SquareMat m(4, &arena);
+        m[3][3] = 2.0;
+        SquareMat p = (m * m) + m;
+        CHECK(p[3][3] == 6.0);
+        CHECK(!p == 0.0);
+    }
+}
+
+TEST_CASE("Buffer pool") {
+    BufferPool& pool = BufferPool::local();
+    pool.clear();
+    pool.resetStats();
+    
+    SUBCASE("Destroyed buffers are reused by same-size matrices") {
+        { SquareMat a(5); }
+        CHECK(pool.stats().misses == 1);
+        CHECK(pool.stats().returns == 1);
+        CHECK(pool.cachedBytes() == 5 * 8 * sizeof(double));  // 5 rows padded to 8 elements
+        
+        SquareMat b(5);
+        CHECK(pool.stats().hits == 1);
+        CHECK(pool.cachedBytes() == 0);
+        CHECK(b[4][4] == 0.0);  // Recycled buffers are still zero-initialized
+    }
+    
+    SUBCASE("Steady-state loops stop missing") {
+        SquareMat m = SquareMat::identity(6);
+        m = m * m;
+        pool.resetStats();
+        for (int i = 0; i < 20; ++i) {
+            m = (m * m) + m;
+            m++;
+        }
+        CHECK(pool.stats().misses == 0);
+        CHECK(pool.stats().hits > 0);
+    }
+    
+    SUBCASE("Caps are respected") {
+        pool.setMaxBuffersPerSize(1);
+        {
+            SquareMat a(7);
+            SquareMat b(7);
+        }
+        CHECK(pool.stats().returns == 1);
+        CHECK(pool.stats().drops == 1);
+        
+        pool.setMaxBytes(0);
+        CHECK(pool.cachedBytes() == 0);
+        { SquareMat c(7); }
+        CHECK(pool.stats().drops == 2);
+        
+        pool.setMaxBuffersPerSize(BufferPool::DEFAULT_MAX_BUFFERS_PER_SIZE);
+        pool.setMaxBytes(BufferPool::DEFAULT_MAX_BYTES);
+    }
+    
+    SUBCASE("Matrices on custom resources bypass the pool") {
+        std::pmr::monotonic_buffer_resource arena;
+        { SquareMat a(4, &arena); }
+        CHECK(pool.stats().misses == 0);
+        CHECK(pool.stats().returns == 0);
+    }
+    
+    SUBCASE("Disabled pool forwards to the heap") {
+        pool.setEnabled(false);
+        { SquareMat a(5); }
+        SquareMat b(5);
+        CHECK(pool.stats().hits == 0);
+        pool.setEnabled(true);
+    }
 }
 
 TEST_CASE("Static methods") {
@@ -268,6 +637,64 @@ TEST_CASE("Arithmetic operators") {
     }
 }
 
+TEST_CASE("Operators on temporaries") {
+    SquareMat m1(2);
+    m1[0][0] = 1.0;
+    m1[0][1] = 2.0;
+    m1[1][0] = 3.0;
+    m1[1][1] = 4.0;
+    
+    SquareMat m2(2);
+    m2[0][0] = 5.0;
+    m2[0][1] = 6.0;
+    m2[1][0] = 7.0;
+    m2[1][1] = 8.0;
+    
+    SUBCASE("Chained expressions give the same results") {
+        SquareMat result = m1 + m2 + m1 + m2;
+        CHECK(result[0][0] == 12.0);
+        CHECK(result[1][1] == 24.0);
+        
+        SquareMat result2 = (m1 * 2) - m2 / 2;
+        CHECK(result2[0][0] == Approx(-0.5));
+        CHECK(result2[1][1] == Approx(4.0));
+        
+        SquareMat result3 = m1 - (m2 * 2);
+        CHECK(result3[0][0] == -9.0);
+        CHECK(result3[1][0] == -11.0);
+        
+        SquareMat result4 = -(m1 % m2) % 7;
+        CHECK(result4[0][0] == Approx(2.0));
+        CHECK(result4[1][1] == Approx(3.0));
+    }
+    
+    SUBCASE("Left temporary buffer is reused") {
+        SquareMat big = SquareMat::identity(5);
+        SquareMat t = big * 2.0;
+        const double* storage = &t[0][0];
+        SquareMat result = std::move(t) + big;
+        CHECK(&result[0][0] == storage);
+        CHECK(result[0][0] == 3.0);
+    }
+    
+    SUBCASE("Right temporary buffer is reused") {
+        SquareMat big = SquareMat::identity(5);
+        SquareMat t = big / 0.5;
+        const double* storage = &t[0][0];
+        SquareMat result = big - std::move(t);
+        CHECK(&result[0][0] == storage);
+        CHECK(result[0][0] == -1.0);
+        CHECK(result[4][4] == -1.0);
+    }
+    
+    SUBCASE("Size mismatch still throws") {
+        SquareMat m3(3);
+        CHECK_THROWS_AS(m1 + SquareMat(3), std::invalid_argument);
+        CHECK_THROWS_AS(SquareMat(3) - m1, std::invalid_argument);
+        CHECK_THROWS_AS(std::move(m3) % SquareMat(2), std::invalid_argument);
+    }
+}
+
 TEST_CASE("Power operator") {
     SUBCASE("Power 0 returns identity") {
         SquareMat m(2);
@@ -313,6 +740,367 @@ TEST_CASE("Power operator") {
         CHECK(result[1][0] == 15.0);
         CHECK(result[1][1] == 22.0);
     }
+    
+    SUBCASE("Powers match repeated multiplication") {
+        for (int n : {3, 40}) {
+            CAPTURE(n);
+            SquareMatI64 m(n);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    m[i][j] = (i * 3 + j * 5) % 4 - 1;
+                }
+            }
+            SquareMatI64 expected = m;
+            for (int power = 2; power <= 13; ++power) {
+                expected = expected * m;
+                CAPTURE(power);
+                CHECK(sameElements(m ^ power, expected));
+            }
+        }
+    }
+    
+    SUBCASE("Negative powers use the inverse") {
+        SquareMat m(2);
+        m[0][0] = 4.0;
+        m[0][1] = 7.0;
+        m[1][0] = 2.0;
+        m[1][1] = 6.0;
+        SquareMat inverse = m ^ -1;  // 1/10 * [[6, -7], [-2, 4]]
+        CHECK(inverse[0][0] == doctest::Approx(0.6));
+        CHECK(inverse[0][1] == doctest::Approx(-0.7));
+        CHECK(inverse[1][0] == doctest::Approx(-0.2));
+        CHECK(inverse[1][1] == doctest::Approx(0.4));
+        
+        SquareMat a = SquareMat::identity(40) * 50.0;
+        for (int i = 0; i < 40; ++i) {
+            for (int j = 0; j < 40; ++j) {
+                a[i][j] += (i * 7 + j * 13) % 19 - 9;
+            }
+        }
+        SquareMat cube = (a ^ -3) * (a ^ 3);
+        double worst = 0.0;
+        for (int i = 0; i < 40; ++i) {
+            for (int j = 0; j < 40; ++j) {
+                worst = std::max(worst, std::abs(cube[i][j] - (i == j ? 1.0 : 0.0)));
+            }
+        }
+        CHECK(worst < 1e-9);
+        
+        // Unimodular integer matrices have exact integer inverses
+        SquareMatI64 fibonacci(2);
+        fibonacci[0][0] = 1;
+        fibonacci[0][1] = 1;
+        fibonacci[1][0] = 1;
+        SquareMatI64 back = fibonacci ^ -10;
+        CHECK(back[0][0] == 34);
+        CHECK(back[0][1] == -55);
+        CHECK(back[1][1] == 89);
+        CHECK(sameElements(back * (fibonacci ^ 10), SquareMatI64::identity(2)));
+        CHECK(sameElements(SquareMatI32::identity(3) ^ (-2147483647 - 1), SquareMatI32::identity(3)));
+    }
+    
+    SUBCASE("Singular matrices have no negative powers") {
+        SquareMat singular(3);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                singular[i][j] = i * 3 + j + 1.0;
+            }
+        }
+        CHECK_THROWS_AS(singular ^ -1, std::invalid_argument);
+        CHECK_THROWS_AS(SquareMat(4) ^ -2, std::invalid_argument);
+        CHECK_THROWS_AS(singular.inverse(), std::invalid_argument);
+        
+        SquareMatI32 doubled = SquareMatI32::identity(2) * 2;  // inverse is not integral
+        CHECK_THROWS_AS(doubled ^ -1, std::invalid_argument);
+    }
+    
+    SUBCASE("Badly scaled matrices still invert") {
+        SquareMat tiny(2);
+        tiny[0][0] = 1e-20;
+        tiny[1][1] = 1.0;
+        SquareMat inverse = tiny.inverse();
+        CHECK(inverse[0][0] == doctest::Approx(1e20));
+        CHECK(inverse[1][1] == 1.0);
+        CHECK(inverse[0][1] == 0.0);
+        
+        SquareMat scaled(3);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                scaled[i][j] = (i == j ? 4.0 : 1.0) * std::pow(1e-12, i);
+            }
+        }
+        // scaled = D B with B = 3 I + ones, so its inverse is B^-1 D^-1 with B^-1 = (6 I - ones) / 18
+        SquareMat inverseScaled = scaled.inverse();
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                CAPTURE(i);
+                CAPTURE(j);
+                CHECK(inverseScaled[i][j] == doctest::Approx((i == j ? 5.0 : -1.0) / 18.0 * std::pow(1e12, j)));
+            }
+        }
+    }
+    
+    SUBCASE("Integer inverses are exact") {
+        // Q^p = [[F(p+1), F(p)], [F(p), F(p-1)]] has determinant (-1)^p and Q^-p = [[F(p-1), -F(p)], [-F(p), F(p+1)]]
+        SquareMatI64 q(2);
+        q[0][0] = 1;
+        q[0][1] = 1;
+        q[1][0] = 1;
+        for (int p : {40, 50, 80}) {
+            CAPTURE(p);
+            SquareMatI64 power = q ^ p;
+            SquareMatI64 inverse = power.inverse();
+            CHECK(inverse[0][0] == power[1][1]);
+            CHECK(inverse[1][1] == power[0][0]);
+            CHECK(inverse[0][1] == -power[0][1]);
+            CHECK(inverse[1][0] == -power[1][0]);
+            CHECK(sameElements(q ^ -p, inverse));
+        }
+        
+        SquareMatI32 q32(2);
+        q32[0][0] = 1;
+        q32[0][1] = 1;
+        q32[1][0] = 1;
+        SquareMatI32 inverse32 = (q32 ^ 40).inverse();
+        CHECK(inverse32[0][0] == 63245986);   // F(39)
+        CHECK(inverse32[0][1] == -102334155); // -F(40)
+        CHECK(inverse32[1][1] == 165580141);  // F(41)
+        
+        // Products of elementary matrices are unimodular
+        const std::int64_t multipliers[] = {-1, 2, 1};
+        SquareMatI64 u = SquareMatI64::identity(6);
+        for (int step = 0; step < 30; ++step) {
+            int target = step % 6;
+            int source = (step * 5 + 1) % 6;
+            if (source == target) {
+                source = (source + 1) % 6;
+            }
+            for (int j = 0; j < 6; ++j) {
+                u[target][j] += multipliers[step % 3] * u[source][j];
+            }
+        }
+        CHECK(sameElements(u * u.inverse(), SquareMatI64::identity(6)));
+        CHECK(sameElements(u.inverse() * u, SquareMatI64::identity(6)));
+        
+        SquareMatI64 even(2);
+        even[0][0] = 3;
+        even[0][1] = 1;
+        even[1][0] = 1;
+        even[1][1] = 1;  // determinant 2
+        CHECK_THROWS_AS(even.inverse(), std::invalid_argument);
+        SquareMatI64 rankOne(2);
+        rankOne[0][0] = 2;
+        rankOne[0][1] = 4;
+        rankOne[1][0] = 1;
+        rankOne[1][1] = 2;
+        CHECK_THROWS_AS(rankOne.inverse(), std::invalid_argument);
+        
+        SquareMatI64 huge(3);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                huge[i][j] = (i == j ? 4 : (i + j) % 3 + 1) * (std::int64_t(1) << 60) + i - j;
+            }
+        }
+        CHECK_THROWS_AS(huge.inverse(), std::overflow_error);
+    }
+    
+    SUBCASE("High powers take logarithmically many products") {
+        // A cyclic shift of 5 elements has order 5, and the Fibonacci matrix gives F(p)
+        SquareMatI32 shift(5);
+        for (int i = 0; i < 5; ++i) {
+            shift[i][(i + 1) % 5] = 1;
+        }
+        CHECK(sameElements(shift ^ 1000000000, SquareMatI32::identity(5)));
+        CHECK(sameElements(shift ^ 2147483647, shift ^ 2));
+        
+        SquareMatI64 fibonacci(2);
+        fibonacci[0][0] = 1;
+        fibonacci[0][1] = 1;
+        fibonacci[1][0] = 1;
+        CHECK((fibonacci ^ 90)[0][1] == 2880067194370816120LL);
+    }
+}
+
+TEST_CASE("Characteristic polynomial and power strategies") {
+    SUBCASE("Characteristic polynomial") {
+        SquareMatI64 m(2);
+        m[0][0] = 1;
+        m[0][1] = 2;
+        m[1][0] = 3;
+        m[1][1] = 4;
+        CHECK(m.characteristicPolynomial() == std::vector<std::int64_t>{-2, -5, 1});
+        
+        SquareMatI32 shift(5);
+        for (int i = 0; i < 5; ++i) {
+            shift[i][(i + 1) % 5] = 1;
+        }
+        CHECK(shift.characteristicPolynomial() == std::vector<std::int32_t>{-1, 0, 0, 0, 0, 1});
+        
+        SquareMat triangular(3);
+        triangular[0][0] = 2.0;
+        triangular[0][2] = 7.0;
+        triangular[1][1] = 3.0;
+        triangular[2][2] = 0.5;
+        std::vector<double> c = triangular.characteristicPolynomial();  // (x - 2)(x - 3)(x - 0.5)
+        REQUIRE(c.size() == 4);
+        CHECK(c[0] == doctest::Approx(-3.0));
+        CHECK(c[1] == doctest::Approx(8.5));
+        CHECK(c[2] == doctest::Approx(-5.5));
+        CHECK(c[3] == 1.0);
+    }
+    
+    SUBCASE("Both strategies agree with operator^") {
+        for (int n : {1, 2, 4, 7}) {
+            SquareMatI64 m(n);
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    m[i][j] = (2 * i + 3 * j) % 3 - 1;
+                }
+            }
+            for (int p : {0, 1, 3, 7, 8, 15, 20}) {
+                CAPTURE(n);
+                CAPTURE(p);
+                CHECK(sameElements(m.power(p, PowerStrategy::CayleyHamilton), m ^ p));
+                CHECK(sameElements(m.power(p, PowerStrategy::Squaring), m ^ p));
+                CHECK(sameElements(m.power(p), m ^ p));
+            }
+        }
+    }
+    
+    SUBCASE("Huge exponents on small matrices") {
+        SquareMatI32 shift(5);
+        for (int i = 0; i < 5; ++i) {
+            shift[i][(i + 1) % 5] = 1;
+        }
+        CHECK(sameElements(shift.power(1000000000000000002ULL, PowerStrategy::CayleyHamilton), shift ^ 2));
+        CHECK(sameElements(shift.power(~std::uint64_t(0)), SquareMatI32::identity(5)));  // 2^64 - 1 = 0 mod 5
+        
+        SquareMat projection(2);
+        projection[0][0] = 0.5;
+        projection[0][1] = 0.5;
+        projection[1][0] = 0.5;
+        projection[1][1] = 0.5;
+        SquareMat projected = projection.power(123456789012345ULL, PowerStrategy::CayleyHamilton);
+        CHECK(projected[0][1] == doctest::Approx(0.5));
+        CHECK(projected[1][1] == doctest::Approx(0.5));
+    }
+    
+    SUBCASE("Automatic selection counts matrix products") {
+        CHECK(SquareMatI64::selectPowerStrategy(2, std::uint64_t(1) << 40) == PowerStrategy::CayleyHamilton);
+        CHECK(SquareMatI64::selectPowerStrategy(3, 15) == PowerStrategy::CayleyHamilton);  // 4 < 3 + 3
+        CHECK(SquareMatI64::selectPowerStrategy(4, 15) == PowerStrategy::Squaring);        // tie: 6 = 3 + 3
+        CHECK(SquareMatI64::selectPowerStrategy(100, ~std::uint64_t(0)) == PowerStrategy::Squaring);
+        CHECK(SquareMatI64::selectPowerStrategy(1, 1) == PowerStrategy::Squaring);
+        CHECK(SquareMatI32::selectPowerStrategy(3, 15) == PowerStrategy::CayleyHamilton);
+    }
+    
+    SUBCASE("Automatic keeps squaring for floating-point matrices") {
+        CHECK(SquareMat::selectPowerStrategy(2, std::uint64_t(1) << 40) == PowerStrategy::Squaring);
+        CHECK(SquareMatF::selectPowerStrategy(3, 15) == PowerStrategy::Squaring);
+        
+        // Eigenvalues 10, 1 and 0.1: the characteristic polynomial route loses the small ones
+        SquareMat a(3);
+        a[0][0] = 10.0;
+        a[1][1] = 1.0;
+        a[2][2] = 0.1;
+        a[0][1] = 0.5;
+        a[1][2] = 0.5;
+        SquareMat automatic = a.power(40);
+        CHECK(sameElements(automatic, a.power(40, PowerStrategy::Squaring)));
+        CHECK(automatic[0][0] == doctest::Approx(1e40));
+        CHECK(automatic[1][1] == doctest::Approx(1.0));
+        CHECK(automatic[2][2] == doctest::Approx(1e-40).epsilon(1e-9));
+        CHECK(automatic[1][0] == 0.0);
+    }
+}
+
+TEST_CASE("Power cache") {
+    SquareMatI64 m(6);
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            m[i][j] = (i + 2 * j) % 3 - 1;
+        }
+    }
+    
+    SUBCASE("Matches operator^ and reuses squarings") {
+        PowerCacheI64 cache(m);
+        CHECK(sameElements(cache.power(0), SquareMatI64::identity(6)));
+        CHECK(sameElements(cache.power(1), m));
+        CHECK(cache.cachedRungs() == 0);
+        for (int k : {13, 8, 29, 2, 31, 30}) {
+            CAPTURE(k);
+            CHECK(sameElements(cache.power(k), m ^ k));
+        }
+        CHECK(cache.cachedRungs() == 4);  // m^2, m^4, m^8, m^16
+        CHECK(cache.memoryUsage() > 0);
+        CHECK(cache.memoryUsage() <= cache.memoryCapacity());
+        CHECK_THROWS_AS(cache.power(-1), std::invalid_argument);
+    }
+    
+    SUBCASE("Memory cap evicts rungs but keeps results exact") {
+        PowerCacheI64 probe(m);
+        probe.power(2);
+        const std::size_t rungBytes = probe.memoryUsage();
+        
+        PowerCacheI64 cache(m, 2 * rungBytes);
+        CHECK(sameElements(cache.power(31), m ^ 31));
+        CHECK(cache.cachedRungs() == 2);
+        CHECK(cache.memoryUsage() <= 2 * rungBytes);
+        CHECK(sameElements(cache.power(6), m ^ 6));
+        
+        cache.setMemoryCapacity(rungBytes);
+        CHECK(cache.cachedRungs() == 1);
+        cache.setMemoryCapacity(0);
+        CHECK(cache.cachedRungs() == 0);
+        CHECK(sameElements(cache.power(21), m ^ 21));
+        CHECK(cache.memoryUsage() == 0);
+    }
+    
+    SUBCASE("Mutating the base invalidates the cache") {
+        PowerCacheI64 cache(m);
+        CHECK(sameElements(cache.power(10), m ^ 10));
+        m[2][3] = 5;
+        CHECK(sameElements(cache.power(10), m ^ 10));
+        
+        m += SquareMatI64::identity(6);
+        CHECK(sameElements(cache.power(7), m ^ 7));
+        m = SquareMatI64::identity(6) * 2;
+        CHECK(cache.power(7)[5][5] == 128);
+        
+        SquareMatI64 taken = std::move(m);
+        CHECK_THROWS_AS(cache.power(3), std::length_error);
+    }
+    
+    SUBCASE("Writes through an earlier view or row proxy invalidate the cache") {
+        auto row = m[2];
+        MatrixView<std::int64_t> whole = m.view();
+        PowerCacheI64 cache(m);
+        CHECK(sameElements(cache.power(10), m ^ 10));
+        
+        row[3] = 7;
+        CHECK(sameElements(cache.power(10), m ^ 10));
+        
+        cache.power(12);
+        whole(4, 1) = -2;
+        CHECK(sameElements(cache.power(12), m ^ 12));
+        CHECK(sameElements(cache.power(5), m ^ 5));
+    }
+    
+    SUBCASE("Reading the base keeps the cache") {
+        const SquareMatI64& readOnly = m;
+        PowerCacheI64 cache(m);
+        cache.power(12);
+        
+        std::int64_t trace = 0;
+        for (int i = 0; i < 6; ++i) {
+            trace += m[i][i];  // Non-const access that only reads
+        }
+        SquareMatI64 squared = readOnly * readOnly;
+        
+        CHECK(trace == -6);
+        CHECK(cache.cachedRungs() == 3);
+        CHECK(sameElements(cache.power(2), squared));
+    }
 }
 
 TEST_CASE("Increment and decrement operators") {
@@ -571,4 +1359,930 @@ TEST_CASE("Compound assignment operators") {
         CHECK(m[1][0] == 21.0);
         CHECK(m[1][1] == 32.0);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Fixed-size matrices") {
+    SUBCASE("Operators are usable at compile time") {
+        constexpr FixedSquareMat<2> a{1.0, 2.0,
+                                      3.0, 4.0};
+        constexpr FixedSquareMat<2> b{5.0, 6.0,
+                                      7.0, 8.0};
+        constexpr FixedSquareMat<2> sum = a + b;
+        constexpr FixedSquareMat<2> product = a * b;
+        constexpr FixedSquareMat<2> transposed = ~a;
+        constexpr FixedSquareMat<2> squared = a ^ 2;
+        static_assert(sum(1, 1) == 12.0, "constexpr addition");
+        static_assert(product(0, 1) == 22.0, "constexpr multiplication");
+        static_assert(transposed(0, 1) == 3.0, "constexpr transpose");
+        static_assert(squared(1, 0) == 15.0, "constexpr power");
+        static_assert((!a) == -2.0, "constexpr determinant");
+        CHECK(product(1, 0) == 43.0);
+        CHECK((2.0 * a)(1, 1) == 8.0);
+    }
+    
+    SUBCASE("Results match SquareMat") {
+        FixedSquareMat<3> f{2.0, -1.0, 0.0,
+                            1.0, 3.0, 4.0,
+                            0.5, 0.0, 1.0};
+        SquareMat m(f);
+        
+        FixedSquareMat<3> power = f ^ 5;
+        SquareMat expected = m ^ 5;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                CHECK(power(i, j) == Approx(expected[i][j]));
+                CHECK((~f)(i, j) == m[j][i]);
+            }
+        }
+        CHECK(!f == Approx(!m));
+        CHECK((f ^ 0)(2, 2) == 1.0);
+    }
+    
+    SUBCASE("Conversions between fixed and dynamic matrices") {
+        SquareMat m = SquareMat::identity(4) * 3.0;
+        FixedSquareMat<4> f(m);
+        CHECK(f(3, 3) == 3.0);
+        
+        SquareMat back(f + f);
+        CHECK(back.dimension() == 4);
+        CHECK(back[2][2] == 6.0);
+        
+        CHECK_THROWS_AS(static_cast<FixedSquareMat<3>>(m), std::invalid_argument);
+    }
+    
+    SUBCASE("Invalid use throws") {
+        FixedSquareMat<2> f;
+        CHECK_THROWS_AS(f(2, 0), std::out_of_range);
+        CHECK_THROWS_AS(f(0, -1), std::out_of_range);
+        CHECK_THROWS_WITH_AS(f ^ -1, "FixedSquareMat supports only non-negative powers; use SquareMat", std::invalid_argument);
+        CHECK_THROWS_AS((FixedSquareMat<1>{1.0, 2.0}), std::length_error);
+    }
+}
+
+TEST_CASE("Element types") {
+    SUBCASE("Integer matrices are exact") {
+        SquareMatI64 m(2);
+        m[0][0] = 3000000000LL;
+        m[0][1] = -7;
+        m[1][0] = 5;
+        m[1][1] = 2;
+        
+        SquareMatI64 product = m * m;
+        CHECK(product[0][0] == 3000000000LL * 3000000000LL - 35);
+        
+        SquareMatI64 mod = m % 4;
+        CHECK(mod[0][0] == 0);
+        CHECK(mod[0][1] == 1);
+        CHECK(mod[1][0] == 1);
+        
+        CHECK(!m == 3000000000LL * 2 + 35);
+        CHECK((m / 2)[1][0] == 2);
+        CHECK_THROWS_AS(m / 0, std::invalid_argument);
+    }
+    
+    SUBCASE("32-bit integer and float matrices") {
+        SquareMatI32 i = SquareMatI32::identity(3) * 4;
+        i[0][2] = -9;
+        CHECK((i % 5)[0][2] == 1);
+        CHECK((i ^ 2)[0][2] == -72);
+        CHECK(!i == 64);
+        
+        SquareMatF f(2);
+        f[0][0] = 1.5f;
+        f[1][1] = 2.0f;
+        CHECK((f * f)[0][0] == 2.25f);
+        CHECK(!f == 3.0f);
+        CHECK(((~f) + f)[1][1] == 4.0f);
+    }
+    
+    SUBCASE("Mixed types are promoted explicitly") {
+        SquareMatI32 i = SquareMatI32::identity(2);
+        SquareMat d(2);
+        d[0][0] = 0.5;
+        
+        SquareMat sum = SquareMat(i) + d;
+        CHECK(sum[0][0] == 1.5);
+        CHECK(sum[1][1] == 1.0);
+        
+        SquareMatI32 truncated(sum * 3.0);
+        CHECK(truncated[0][0] == 4);
+        
+        SquareMatF narrowed(SquareMat::identity(6) / 4.0);
+        CHECK(narrowed[5][5] == 0.25f);
+    }
+}
+
+TEST_CASE("Padded leading dimension") {
+    SUBCASE("Rows are padded to cache lines and away from aliasing strides") {
+        CHECK(SquareMat(3).leadingDimension() == 3);
+        CHECK(SquareMat(5).leadingDimension() == 8);
+        CHECK(SquareMat(9).leadingDimension() == 16);
+        CHECK(SquareMat(64).leadingDimension() == 72);
+        CHECK(SquareMat(128).leadingDimension() == 136);
+        CHECK(SquareMatF(64).leadingDimension() == 64);
+        CHECK(SquareMatF(128).leadingDimension() == 144);
+    }
+    
+    SUBCASE("Every row starts on a cache line") {
+        SquareMat m(13);
+        for (int i = 0; i < 13; ++i) {
+            CHECK(reinterpret_cast<std::uintptr_t>(&m[i][0]) % SquareMat::ALIGNMENT == 0);
+        }
+        CHECK(&m[1][0] - &m[0][0] == m.leadingDimension());
+    }
+    
+    SUBCASE("Kernels ignore the padding") {
+        SquareMat m(64);
+        for (int i = 0; i < 64; ++i) {
+            for (int j = 0; j < 64; ++j) {
+                m[i][j] = i - j;
+            }
+        }
+        ++m;
+        SquareMat transposed(64);
+        for (int i = 0; i < 64; ++i) {
+            for (int j = 0; j < 64; ++j) {
+                transposed[i][j] = j - i + 1.0;
+            }
+        }
+        CHECK((m - ~m)[10][3] == 14.0);
+        CHECK(sameElements(m * SquareMat::identity(64), m));
+        CHECK(sameElements(~m, transposed));
+        
+        SquareMatF f(m);
+        CHECK(f.leadingDimension() != m.leadingDimension());
+        CHECK(f[63][0] == 64.0f);
+        CHECK(sameElements(SquareMat(f), m));
+    }
+}
+
+TEST_CASE("Matrix views") {
+    SquareMat m(6);
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            m[i][j] = i * 6 + j;
+        }
+    }
+    
+    SUBCASE("Blocks share the matrix buffer") {
+        MatrixView<double> b = m.block(2, 3, 3);
+        CHECK(b.dimension() == 3);
+        CHECK(b(0, 0) == 15.0);
+        CHECK(b(2, 2) == 29.0);
+        b(1, 1) = -1.0;
+        CHECK(m[3][4] == -1.0);
+        
+        CHECK(b.block(1, 1, 2)(0, 0) == -1.0);
+        CHECK_THROWS_AS(b(3, 0), std::out_of_range);
+        CHECK_THROWS_AS(m.block(4, 4, 3), std::out_of_range);
+    }
+    
+    SUBCASE("Read-only operations accept views") {
+        const SquareMat& cm = m;
+        MatrixView<const double> top = cm.block(0, 0, 3);
+        MatrixView<const double> bottom = cm.block(3, 3, 3);
+        
+        SquareMat copy(top);
+        CHECK(copy.dimension() == 3);
+        CHECK(copy[2][2] == 14.0);
+        
+        SquareMat sum = copy + bottom;
+        CHECK(sum[0][0] == 21.0);
+        CHECK((copy - bottom)[1][1] == -21.0);
+        CHECK((copy % bottom)[0][1] == 22.0);
+        CHECK((copy * SquareMat::identity(3).view())[2][0] == 12.0);
+        CHECK(SquareMat::transpose(top)[0][2] == 12.0);
+        
+        copy += bottom;
+        copy -= top;
+        CHECK(copy[0][0] == 21.0);
+        copy *= SquareMat::identity(3).view();
+        copy %= bottom;
+        CHECK(copy[0][0] == 21.0 * 21.0);
+        CHECK_THROWS_AS(copy + cm.block(0, 0, 2), std::invalid_argument);
+    }
+    
+    SUBCASE("Wrapping an external buffer") {
+        double buffer[2 * 5] = {1.0, 2.0, 99.0, 99.0, 99.0,
+                                3.0, 4.0, 99.0, 99.0, 99.0};
+        MatrixView<double> external(buffer, 2, 5);
+        SquareMat id = SquareMat::identity(2);
+        
+        CHECK((id * external)[1][0] == 3.0);
+        CHECK(SquareMat::determinant(external) == -2.0);
+        CHECK_THROWS_AS(MatrixView<double>(buffer, 3, 2), std::invalid_argument);
+        CHECK_THROWS_AS(MatrixView<double>(buffer, 0), std::length_error);
+    }
+    
+    SUBCASE("Determinant of blocks and larger matrices without minor copies") {
+        SquareMat a(5);
+        double values[25] = {2, -1, 0, 3, 1,
+                             1, 4, 2, 0, -2,
+                             0, 1, 3, 1, 1,
+                             5, 0, -1, 2, 0,
+                             1, 2, 1, 0, 4};
+        for (int i = 0; i < 5; ++i) {
+            for (int j = 0; j < 5; ++j) {
+                a[i][j] = values[i * 5 + j];
+            }
+        }
+        FixedSquareMat<5> f(a);
+        CHECK(!a == Approx(!f));
+        CHECK(SquareMat::determinant(a.block(1, 1, 3)) == Approx(!SquareMat(a.block(1, 1, 3))));
+        CHECK(SquareMat::determinant(a.block(1, 1, 3)) == Approx(24.0));
+        
+        // Laplace expansion along row 2 through minor views
+        MatrixView<const double> whole = a.view();
+        double expansion = 0.0;
+        for (int j = 0; j < 5; ++j) {
+            double sign = (j % 2 == 0) ? 1.0 : -1.0;
+            expansion += sign * a[2][j] * SquareMat::determinant(whole.minor(2, j));
+        }
+        CHECK(expansion == Approx(!a));
+        CHECK(SquareMat::determinant(a.view().minor(0, 0)) == Approx(!SquareMat(a.block(1, 1, 4))));
+    }
+    
+    SUBCASE("Minor views skip one row and column") {
+        SquareMat m(4);
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                m[i][j] = i * 10 + j;
+            }
+        }
+        MinorView<double> minor = m.view().minor(1, 2);
+        CHECK(minor.dimension() == 3);
+        CHECK(minor(0, 0) == 0.0);
+        CHECK(minor(0, 2) == 3.0);
+        CHECK(minor(1, 1) == 21.0);
+        CHECK(minor(2, 2) == 33.0);
+        minor(2, 0) = -1.0;
+        CHECK(m[3][0] == -1.0);
+        MinorView<const double> readOnly = minor;
+        CHECK(readOnly.skippedRow() == 1);
+        CHECK(readOnly.skippedColumn() == 2);
+        
+        CHECK_THROWS_AS(minor(3, 0), std::out_of_range);
+        CHECK_THROWS_AS(m.view().minor(4, 0), std::out_of_range);
+        CHECK_THROWS_AS(m.view().block(0, 0, 1).minor(0, 0), std::length_error);
+    }
+}
+
+TEST_CASE("Blocked matrix multiplication") {
+    SUBCASE("Matches the reference product across tile edges") {
+        for (int n : {1, 5, 31, 33, 70, 131}) {
+            SquareMat a = patternMatrix<double>(n, 1);
+            SquareMat b = patternMatrix<double>(n, 2);
+            SquareMat expected = naiveProduct(a, b);
+            CHECK(sameElements(a * b, expected));
+        }
+    }
+    
+    SUBCASE("Small block sizes split every loop") {
+        GemmSettingsGuard settings;
+        gemm::setBlockSizes({12, 20, 24});
+        SquareMatI64 a = patternMatrix<std::int64_t>(67, 3);
+        SquareMatI64 b = patternMatrix<std::int64_t>(67, 4);
+        SquareMatI64 product = a;
+        product *= b;
+        CHECK(sameElements(product, naiveProduct(a, b)));
+        CHECK_THROWS_AS(gemm::setBlockSizes({0, 1, 1}), std::invalid_argument);
+    }
+    
+    SUBCASE("Accumulating form C = alpha * A * B + beta * C") {
+        SquareMatF a = patternMatrix<float>(40, 5);
+        SquareMatF b = patternMatrix<float>(40, 6);
+        SquareMatF c = patternMatrix<float>(40, 7);
+        SquareMatF expected = naiveProduct(a, b) * 2.0f + c * 3.0f;
+        gemm::multiply(40, 2.0f, &a[0][0], a.leadingDimension(), &b[0][0], b.leadingDimension(),
+                       3.0f, &c[0][0], c.leadingDimension());
+        CHECK(c[0][0] == expected[0][0]);
+        CHECK(c[39][17] == expected[39][17]);
+        CHECK(c[21][39] == expected[21][39]);
+    }
+}
+
+TEST_CASE("SIMD kernel dispatch") {
+    const simd::Isa detected = simd::detectedIsa();
+    CHECK(simd::activeIsa() == detected);
+    
+    SUBCASE("Every supported instruction set gives the same results") {
+        GemmSettingsGuard settings;
+        SquareMat a = patternMatrix<double>(77, 1);
+        SquareMat b = patternMatrix<double>(77, 2);
+        SquareMat expectedProduct = naiveProduct(a, b);
+        SquareMat expectedSum(77);
+        SquareMat expectedDifference(77);
+        SquareMat expectedHadamard(77);
+        SquareMat expectedScaled(77);
+        SquareMat expectedDivided(77);
+        for (int i = 0; i < 77; ++i) {
+            for (int j = 0; j < 77; ++j) {
+                expectedSum[i][j] = a[i][j] + b[i][j];
+                expectedDifference[i][j] = a[i][j] - b[i][j];
+                expectedHadamard[i][j] = a[i][j] * b[i][j];
+                expectedScaled[i][j] = a[i][j] * 0.5;
+                expectedDivided[i][j] = a[i][j] / 4.0;
+            }
+        }
+        
+        for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+            if (isa > detected) {
+                CHECK_THROWS_AS(simd::setActiveIsa(isa), std::invalid_argument);
+                continue;
+            }
+            simd::setActiveIsa(isa);
+            CAPTURE(simd::isaName(isa));
+            CHECK(simd::activeIsa() == isa);
+            
+            SquareMat accumulated = a;
+            accumulated -= b;
+            CHECK(sameElements(a * b, expectedProduct));
+            CHECK(sameElements(a + b, expectedSum));
+            CHECK(sameElements(a - b, expectedDifference));
+            CHECK(sameElements(a % b, expectedHadamard));
+            CHECK(sameElements(a * 0.5, expectedScaled));
+            CHECK(sameElements(a / 4.0, expectedDivided));
+            CHECK(sameElements(accumulated, expectedDifference));
+        }
+    }
+    
+    SUBCASE("Names") {
+        CHECK(std::string(simd::isaName(simd::Isa::Scalar)) == "Scalar");
+        CHECK(std::string(simd::isaName(simd::Isa::AVX2)) == "AVX2");
+    }
+}
+
+TEST_CASE("GEMM tuning profiles") {
+    GemmSettingsGuard settings;
+    const gemm::TuningProfile original = gemm::currentProfile();
+    CHECK(original.isa == simd::activeIsa());
+    CHECK(original.blocks.mc == gemm::blockSizes().mc);
+    const std::string path = "squaremat_test_profile.txt";
+    
+    SUBCASE("Force and inspect a configuration") {
+        gemm::applyProfile({{24, 40, 72}, simd::Isa::Scalar});
+        gemm::TuningProfile forced = gemm::currentProfile();
+        CHECK(forced.isa == simd::Isa::Scalar);
+        CHECK(forced.blocks.kc == 40);
+        SquareMat a = patternMatrix<double>(90, 1);
+        SquareMat b = patternMatrix<double>(90, 2);
+        CHECK(sameElements(a * b, naiveProduct(a, b)));
+        
+        CHECK_THROWS_AS(gemm::applyProfile({{0, 40, 72}, simd::Isa::Scalar}), std::invalid_argument);
+        CHECK(gemm::currentProfile().blocks.mc == 24);
+    }
+    
+    SUBCASE("Save and load round trip") {
+        gemm::TuningProfile profile = {{96, 192, 1024}, simd::Isa::SSE2};
+        gemm::saveProfile(profile, path);
+        gemm::TuningProfile loaded = gemm::loadProfile(path);
+        CHECK(loaded.isa == simd::Isa::SSE2);
+        CHECK(loaded.blocks.mc == 96);
+        CHECK(loaded.blocks.kc == 192);
+        CHECK(loaded.blocks.nc == 1024);
+        std::remove(path.c_str());
+    }
+    
+    SUBCASE("Malformed and missing profiles") {
+        CHECK_THROWS_AS(gemm::loadProfile("no_such_directory/profile.txt"), std::runtime_error);
+        for (const char* text : {"isa = AVX2\nmc = 64\nkc = 64\n", "isa = MMX\nmc = 1\nkc = 1\nnc = 1\n",
+                                 "isa = AVX2\nmc = 64x\nkc = 64\nnc = 64\n", "mc 64\n",
+                                 "isa = AVX2\nmc = 64\nkc = -1\nnc = 64\n", "depth = 3\n"}) {
+            CAPTURE(text);
+            std::ofstream(path) << text;
+            CHECK_THROWS_AS(gemm::loadProfile(path), std::invalid_argument);
+        }
+        std::remove(path.c_str());
+    }
+    
+    SUBCASE("Autotune applies a working configuration") {
+        CHECK_THROWS_AS(gemm::autotune(0), std::invalid_argument);
+        CHECK_THROWS_AS(gemm::autotune(64, 0), std::invalid_argument);
+        gemm::TuningProfile tuned = gemm::autotune(64, 1);
+        gemm::TuningProfile applied = gemm::currentProfile();
+        CHECK(applied.isa == tuned.isa);
+        CHECK(applied.blocks.mc == tuned.blocks.mc);
+        CHECK(applied.blocks.kc == tuned.blocks.kc);
+        CHECK(applied.blocks.nc == tuned.blocks.nc);
+        SquareMat a = patternMatrix<double>(70, 3);
+        SquareMat b = patternMatrix<double>(70, 4);
+        CHECK(sameElements(a * b, naiveProduct(a, b)));
+    }
+    
+    SUBCASE("Block sizes change while products run") {
+        SquareMat a = patternMatrix<double>(150, 5);
+        SquareMat b = patternMatrix<double>(150, 6);
+        SquareMat expected = naiveProduct(a, b);
+        std::atomic<bool> done(false);
+        std::thread tuner([&done] {
+            for (int i = 0; !done.load(); ++i) {
+                gemm::setBlockSizes(i % 2 == 0 ? gemm::BlockSizes{24, 40, 72} : gemm::DEFAULT_BLOCK_SIZES);
+            }
+        });
+        bool allMatch = true;
+        for (int i = 0; i < 10; ++i) {
+            allMatch = allMatch && sameElements(a * b, expected);
+        }
+        done = true;
+        tuner.join();
+        CHECK(allMatch);
+    }
+}
+
+TEST_CASE("Parallel matrix multiplication") {
+    SUBCASE("Thread counts give identical products") {
+        SquareMat a = patternMatrix<double>(150, 1);
+        SquareMat b = patternMatrix<double>(150, 2);
+        SquareMat serial = a.multiply(b.view(), 1);
+        for (int threads : {2, 3, 8, 64}) {
+            CAPTURE(threads);
+            CHECK(sameElements(a.multiply(b.view(), threads), serial));
+        }
+        CHECK(ThreadPool::instance().workerCount() >= 1);
+        CHECK_THROWS_AS(a.multiply(b.view(), -1), std::invalid_argument);
+    }
+    
+    SUBCASE("Process-wide setting with small blocks") {
+        GemmSettingsGuard settings;
+        gemm::setThreadCount(4);
+        gemm::setBlockSizes({16, 40, 64});
+        CHECK(gemm::threadCount() == 4);
+        SquareMatI32 a = patternMatrix<std::int32_t>(133, 3);
+        SquareMatI32 b = patternMatrix<std::int32_t>(133, 4);
+        CHECK(sameElements(a * b, naiveProduct(a, b)));
+        CHECK_THROWS_AS(gemm::setThreadCount(0), std::invalid_argument);
+        CHECK(gemm::threadCount() == 4);
+    }
+    
+    SUBCASE("Thread pool runs every task once and forwards exceptions") {
+        std::vector<int> hits(100, 0);
+        ThreadPool::instance().parallelFor(100, 4, [&](int task) { hits[task] += 1; });
+        int total = 0;
+        for (int h : hits) {
+            total += h;
+        }
+        CHECK(total == 100);
+        CHECK(*std::min_element(hits.begin(), hits.end()) == 1);
+        
+        CHECK_THROWS_AS(ThreadPool::instance().parallelFor(10, 4, [](int task) {
+            if (task == 3) {
+                throw std::runtime_error("task failed");
+            }
+        }), std::runtime_error);
+    }
+}
+
+TEST_CASE("Strassen-Winograd multiplication") {
+    GemmSettingsGuard settings;
+    gemm::setAlgorithm(gemm::Algorithm::StrassenWinograd);
+    
+    SUBCASE("Exact for integers with odd sizes at several levels") {
+        gemm::setStrassenCrossover(8);
+        for (int n : {9, 16, 67}) {
+            CAPTURE(n);
+            SquareMatI64 a = patternMatrix<std::int64_t>(n, 1);
+            SquareMatI64 b = patternMatrix<std::int64_t>(n, 2);
+            CHECK(sameElements(a * b, naiveProduct(a, b)));
+        }
+    }
+    
+    SUBCASE("Floating point stays within the error bound") {
+        gemm::setStrassenCrossover(16);
+        SquareMat a(101);
+        SquareMat b(101);
+        for (int i = 0; i < 101; ++i) {
+            for (int j = 0; j < 101; ++j) {
+                a[i][j] = std::sin(i * 0.7 + j * 0.3);
+                b[i][j] = std::cos(i * 0.2 - j * 0.9);
+            }
+        }
+        CHECK(maxDifference(a * b, naiveProduct(a, b)) < 1e-10);
+    }
+    
+    SUBCASE("At or below the crossover the classical kernel is used") {
+        gemm::setStrassenCrossover(gemm::DEFAULT_STRASSEN_CROSSOVER);
+        SquareMat a = patternMatrix<double>(40, 3);
+        SquareMat b = patternMatrix<double>(40, 4);
+        SquareMat product = a * b;
+        SquareMat expected = naiveProduct(a, b);
+        CHECK(product[0][0] == expected[0][0]);
+        CHECK(product[39][21] == expected[39][21]);
+        CHECK_THROWS_AS(gemm::setStrassenCrossover(0), std::invalid_argument);
+    }
+    
+    CHECK(gemm::algorithm() == gemm::Algorithm::StrassenWinograd);
+}
+
+TEST_CASE("Fused multiply-accumulate") {
+    SUBCASE("C = alpha * A * B + beta * C in place") {
+        for (int n : {3, 40, 140}) {
+            CAPTURE(n);
+            SquareMat a = patternMatrix<double>(n, 1);
+            SquareMat b = patternMatrix<double>(n, 2);
+            SquareMat c = patternMatrix<double>(n, 3);
+            SquareMat expected = naiveProduct(a, b) * 0.5 + c * 2.0;
+            const double* buffer = &c[0][0];
+            
+            c.gemm(0.5, a.view(), b.view(), 2.0);
+            
+            CHECK(&c[0][0] == buffer);
+            CHECK(sameElements(c, expected));
+        }
+    }
+    
+    SUBCASE("Default beta accumulates and zero beta overwrites") {
+        SquareMatI32 a = patternMatrix<std::int32_t>(6, 4);
+        SquareMatI32 b = patternMatrix<std::int32_t>(6, 5);
+        SquareMatI32 c(6);
+        c.gemm(1, a.view(), b.view());
+        c.gemm(1, a.view(), b.view());
+        CHECK(c[2][3] == 2 * naiveProduct(a, b)[2][3]);
+        c.gemm(3, a.view(), b.view(), 0);
+        CHECK(c[5][1] == 3 * naiveProduct(a, b)[5][1]);
+    }
+    
+    SUBCASE("Operands overlapping the destination") {
+        SquareMat a = patternMatrix<double>(7, 6);
+        SquareMat expected = naiveProduct(a, a) + a;
+        a.gemm(1.0, a.view(), a.view());
+        CHECK(a[0][0] == expected[0][0]);
+        CHECK(a[6][2] == expected[6][2]);
+        
+        SquareMat c = patternMatrix<double>(50, 7);
+        SquareMat b = patternMatrix<double>(50, 8);
+        SquareMat product = naiveProduct(c, b);
+        c.gemm(2.0, c.view(), b.view(), 0.0);
+        CHECK(c[0][0] == 2.0 * product[0][0]);
+        CHECK(c[49][13] == 2.0 * product[49][13]);
+    }
+    
+    SUBCASE("Size mismatch") {
+        SquareMat c(5);
+        SquareMat a(6);
+        CHECK_THROWS_AS(c.gemm(1.0, a.view(), a.view()), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Product with own transpose") {
+    SUBCASE("Matches A * ~A across block and tile edges") {
+        for (int n : {1, 5, 32, 33, 77, 200}) {
+            CAPTURE(n);
+            SquareMat a = patternMatrix<double>(n, 7);
+            CHECK(sameElements(a.gram(), naiveProduct(a, ~a)));
+        }
+    }
+    
+    SUBCASE("Result is exactly symmetric") {
+        SquareMatF a = patternMatrix<float>(150, 8);
+        SquareMatF c = a.gram(3);
+        int asymmetric = 0;
+        for (int i = 0; i < 150; ++i) {
+            for (int j = 0; j < i; ++j) {
+                asymmetric += (c[i][j] != c[j][i]);
+            }
+        }
+        CHECK(asymmetric == 0);
+    }
+    
+    SUBCASE("Integer types and threads") {
+        SquareMatI64 a = patternMatrix<std::int64_t>(130, 9);
+        CHECK(sameElements(a.gram(2), naiveProduct(a, ~a)));
+        SquareMatI32 b = patternMatrix<std::int32_t>(4, 10);
+        CHECK(sameElements(b.gram(), b * ~b));
+        CHECK_THROWS_AS(b.gram(-1), std::invalid_argument);
+    }
+    
+    SUBCASE("Accumulates into a symmetric C through gemm::gram") {
+        const int n = 64;
+        SquareMat a = patternMatrix<double>(n, 11);
+        SquareMat c = naiveProduct(a, ~a);
+        SquareMat expected = naiveProduct(a, ~a) * 3.0;
+        gemm::gram(n, 2.0, &a[0][0], a.leadingDimension(), 1.0, &c[0][0], c.leadingDimension());
+        CHECK(sameElements(c, expected));
+    }
+}
+
+TEST_CASE("Modular products and powers") {
+    SquareMatI64 a(5);
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            a[i][j] = (3 * i + 5 * j) % 11 - 5;
+        }
+    }
+    auto reduced = [](SquareMatI64 mat, std::int64_t m) {
+        for (int i = 0; i < mat.dimension(); ++i) {
+            for (int j = 0; j < mat.dimension(); ++j) {
+                std::int64_t r = mat[i][j] % m;
+                mat[i][j] = (r < 0) ? r + m : r;
+            }
+        }
+        return mat;
+    };
+    
+    SUBCASE("Small exponents match the exact power reduced afterwards") {
+        for (std::int64_t m : {1LL, 2LL, 7LL, 1000000007LL, 4294967296LL, 4294967311LL, 9223372036854775807LL}) {
+            for (int p : {0, 1, 2, 5, 9}) {
+                CAPTURE(m);
+                CAPTURE(p);
+                CHECK(sameElements(powmod(a, p, m), reduced(a ^ p, m)));
+            }
+            CHECK(sameElements(multiplyMod(a, ~a, m), reduced(a * ~a, m)));
+        }
+    }
+    
+    SUBCASE("Huge exponents") {
+        SquareMatI32 fibonacci(2);
+        fibonacci[0][0] = 1;
+        fibonacci[0][1] = 1;
+        fibonacci[1][0] = 1;
+        CHECK(powmod(fibonacci, 1000000000000000000ULL, 1000000007)[0][1] == 209783453);
+        
+        // Reference values computed with arbitrary-precision integers
+        SquareMatI64 mersenne = powmod(a, 1000000000000000009ULL, (std::int64_t(1) << 61) - 1);
+        CHECK(mersenne[0][0] == 909600132860099540LL);
+        CHECK(mersenne[0][2] == 2235388543033996121LL);
+        CHECK(mersenne[0][4] == 1436690921172692038LL);
+        SquareMatI64 even = powmod(a, 123456789123456789ULL, (std::int64_t(1) << 62) + (std::int64_t(1) << 40) + 6);
+        CHECK(even[4][0] == 1715848768145174918LL);
+        CHECK(even[4][3] == 4538949626994713128LL);
+        SquareMatI64 wordSized = powmod(a, ~std::uint64_t(0), std::int64_t(1) << 32);
+        CHECK(wordSized[2][0] == 3123612579LL);
+        CHECK(wordSized[2][4] == 1171354717LL);
+    }
+    
+    SUBCASE("Large matrices with threads") {
+        SquareMatI64 big = patternMatrix<std::int64_t>(150, 3);
+        const std::int64_t m = 998244353;
+        SquareMatI64 square = multiplyMod(big, big, m, 2);
+        CHECK(sameElements(square, reduced(naiveProduct(big, big), m)));
+        CHECK(sameElements(powmod(big, 3, m, 2), multiplyMod(square, big, m)));
+        
+        GemmSettingsGuard settings;
+        for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::SSE2, simd::Isa::AVX2, simd::Isa::AVX512}) {
+            if (isa > simd::detectedIsa()) {
+                continue;
+            }
+            simd::setActiveIsa(isa);
+            CAPTURE(simd::isaName(isa));
+            CHECK(sameElements(multiplyMod(big, big, m), square));
+        }
+    }
+    
+    SUBCASE("Invalid arguments") {
+        CHECK_THROWS_AS(powmod(a, 2, 0), std::invalid_argument);
+        CHECK_THROWS_AS(powmod(a, 2, -5), std::invalid_argument);
+        CHECK_THROWS_AS(powmod(a, 2, 5, -1), std::invalid_argument);
+        CHECK_THROWS_AS(multiplyMod(a, SquareMatI64(3), 5), std::invalid_argument);
+        CHECK_THROWS_AS(powmod(SquareMatI32(2), 2, 4294967296LL), std::invalid_argument);
+        CHECK(powmod(SquareMatI32::identity(2), 2, 2147483648LL)[1][1] == 1);
+    }
+}
+
+TEST_CASE("Vectors and matrix-vector products") {
+    SUBCASE("Construction, access and arithmetic") {
+        Vector v(3);
+        CHECK(v.dimension() == 3);
+        CHECK(v[1] == 0.0);
+        v[0] = 1.0;
+        v[1] = 2.0;
+        v[2] = 3.0;
+        Vector w = v * 2.0;
+        CHECK(w[2] == 6.0);
+        CHECK((w - v) == v);
+        CHECK((v + v) == 2.0 * v);
+        CHECK(v.dot(w) == 28.0);
+        w.axpy(-2.0, v);
+        CHECK(w == Vector(3));
+        CHECK_THROWS_AS(v[3], std::out_of_range);
+        CHECK_THROWS_AS(Vector(0), std::length_error);
+        CHECK_THROWS_AS(v + Vector(4), std::invalid_argument);
+        
+        Vector moved(std::move(v));
+        CHECK(moved[2] == 3.0);
+        CHECK(v.dimension() == 0);
+    }
+    
+    SUBCASE("Move assignment keeps the target's resource") {
+        CountingResource counter;
+        Vector longLived(4);
+        {
+            Vector temporary(4, &counter);
+            temporary[3] = 5.0;
+            longLived = std::move(temporary);
+            CHECK(temporary.dimension() == 4);  // Different resources: copied, not stolen
+            
+            Vector a(2, &counter);
+            Vector b(2, &counter);
+            b = std::move(a);
+            CHECK(a.dimension() == 0);
+        }
+        CHECK(counter.allocations == 3);
+        CHECK(counter.deallocations == 3);
+        CHECK(longLived[3] == 5.0);
+        CHECK_THROWS_AS(Vector(3, nullptr), std::invalid_argument);
+    }
+    
+    SUBCASE("Matrix times vector and vector times matrix") {
+        for (int n : {1, 3, 6, 300}) {
+            CAPTURE(n);
+            SquareMat a = patternMatrix<double>(n, 1);
+            Vector x(n);
+            for (int i = 0; i < n; ++i) {
+                x[i] = (i % 5) - 2;
+            }
+            Vector expectedAx(n);
+            Vector expectedXa(n);
+            for (int i = 0; i < n; ++i) {
+                for (int k = 0; k < n; ++k) {
+                    expectedAx[i] += a[i][k] * x[k];
+                    expectedXa[i] += x[k] * a[k][i];
+                }
+            }
+            CHECK(a * x == expectedAx);
+            CHECK(x * a == expectedXa);
+        }
+        CHECK_THROWS_AS(SquareMat(3) * Vector(4), std::invalid_argument);
+        CHECK_THROWS_AS(Vector(4) * SquareMat(3), std::invalid_argument);
+    }
+    
+    SUBCASE("Threaded kernels match the serial ones") {
+        const int n = 301;
+        SquareMatI64 a = patternMatrix<std::int64_t>(n, 2);
+        VectorI64 x(n);
+        for (int i = 0; i < n; ++i) {
+            x[i] = i % 7 - 3;
+        }
+        VectorI64 serial(n);
+        VectorI64 parallel(n);
+        MatrixView<const std::int64_t> view = a.view();
+        gemv::multiply(n, std::int64_t(1), view.data(), view.leadingDimension(), x.data(), std::int64_t(0),
+                       serial.data(), 1);
+        gemv::multiply(n, std::int64_t(1), view.data(), view.leadingDimension(), x.data(), std::int64_t(0),
+                       parallel.data(), 4);
+        CHECK(serial == parallel);
+        gemv::multiplyTransposed(n, std::int64_t(1), view.data(), view.leadingDimension(), x.data(),
+                                 std::int64_t(0), serial.data(), 1);
+        gemv::multiplyTransposed(n, std::int64_t(1), view.data(), view.leadingDimension(), x.data(),
+                                 std::int64_t(0), parallel.data(), 3);
+        CHECK(serial == parallel);
+        
+        const int length = gemv::PARALLEL_LENGTH_LIMIT + 17;
+        VectorI64 u(length);
+        VectorI64 v(length);
+        for (int i = 0; i < length; ++i) {
+            u[i] = i % 3;
+            v[i] = i % 5;
+        }
+        CHECK(gemv::dot(length, u.data(), v.data(), 4) == gemv::dot(length, u.data(), v.data(), 1));
+        VectorI64 expected = v + u * 3;
+        gemv::axpy(length, std::int64_t(3), u.data(), v.data(), 4);
+        CHECK(v == expected);
+    }
+    
+    SUBCASE("Powers applied to vectors") {
+        // I + cyclic shift: entries of its powers are sums of binomial coefficients
+        const int n = 40;
+        SquareMatI64 a(n);
+        for (int i = 0; i < n; ++i) {
+            a[i][i] = 1;
+            a[i][(i + 1) % n] = 1;
+        }
+        VectorI64 x(n);
+        for (int i = 0; i < n; ++i) {
+            x[i] = i % 5 - 2;
+        }
+        for (int p : {0, 1, 2, 3, 20, 37}) {
+            CAPTURE(p);
+            CHECK(powerTimes(a, p, x) == (a ^ p) * x);
+        }
+        
+        std::vector<VectorI64> block{x, x * 3, VectorI64(n)};
+        block[2][7] = 1;
+        std::vector<VectorI64> powered = powerTimes(a, 33, block, 2);
+        REQUIRE(powered.size() == 3);
+        for (int k = 0; k < 3; ++k) {
+            CHECK(powered[k] == (a ^ 33) * block[k]);
+        }
+        CHECK(powerTimes(a, 5, std::vector<VectorI64>()).empty());
+        
+        SquareMatI32 shift(5);
+        for (int i = 0; i < 5; ++i) {
+            shift[i][(i + 1) % 5] = 1;
+        }
+        VectorI32 y(5);
+        for (int i = 0; i < 5; ++i) {
+            y[i] = i * i;
+        }
+        CHECK(powerTimes(shift, 1000000000000000002ULL, y) == (shift ^ 2) * y);
+        
+        CHECK_THROWS_AS(powerTimes(a, 2, VectorI64(3)), std::invalid_argument);
+        CHECK_THROWS_AS(powerTimes(a, 2, x, -1), std::invalid_argument);
+    }
+    
+    SUBCASE("Choosing between repeated products and squaring") {
+        CHECK(preferRepeatedProducts(40, 3, 1));
+        CHECK_FALSE(preferRepeatedProducts(40, 20, 1));
+        CHECK(preferRepeatedProducts(1000, 50, 1));
+        CHECK_FALSE(preferRepeatedProducts(1000, 50, 8));
+        CHECK_FALSE(preferRepeatedProducts(4, 1000000000000ULL, 1));
+        CHECK(preferRepeatedProducts(4, 0, 1));
+    }
+}
+
+TEST_CASE("Batched small matrices") {
+    SUBCASE("Layout, access and round trips") {
+        SquareMatBatch batch(3, 5);
+        CHECK(batch.dimension() == 3);
+        CHECK(batch.count() == 5);
+        CHECK(batch.planePitch() % SquareMatBatch::LANES == 0);
+        batch(4, 2, 1) = 7.0;
+        CHECK(batch.get(4)[2][1] == 7.0);
+        batch.set(1, SquareMat::identity(3));
+        CHECK(batch(1, 0, 0) == 1.0);
+        CHECK(batch(1, 0, 1) == 0.0);
+        CHECK_THROWS_AS(batch(5, 0, 0), std::out_of_range);
+        CHECK_THROWS_AS(batch(0, 3, 0), std::out_of_range);
+        CHECK_THROWS_AS(batch.set(0, SquareMat(4)), std::invalid_argument);
+        CHECK_THROWS_AS(SquareMatBatch(3, 0), std::length_error);
+        CHECK_THROWS_AS(batch * SquareMatBatch(3, 6), std::invalid_argument);
+    }
+    
+    SUBCASE("Assignment keeps the target's resource") {
+        CountingResource counter;
+        SquareMatBatch longLived(2, 3);
+        {
+            SquareMatBatch temporary(2, 3, &counter);
+            temporary(2, 1, 0) = 4.0;
+            longLived = std::move(temporary);
+            CHECK(temporary.count() == 3);  // Different resources: copied, not stolen
+            
+            SquareMatBatch copy(2, 5, &counter);
+            copy = longLived;
+            CHECK(copy(2, 1, 0) == 4.0);
+        }
+        CHECK(counter.deallocations == counter.allocations);
+        CHECK(longLived(2, 1, 0) == 4.0);
+        CHECK_THROWS_AS(SquareMatBatch(2, 2, nullptr), std::invalid_argument);
+        
+        // Shapes with different pitches, in both directions and through the copying move
+        SquareMatBatchI64 small(2, 1);
+        small(0, 1, 0) = 7;
+        SquareMatBatchI64 large(4, 100);
+        large.set(99, patternMatrix<std::int64_t>(4, 3));
+        SquareMatBatchI64 grown(4, 100);
+        grown = small;
+        CHECK(grown.dimension() == 2);
+        CHECK(grown.count() == 1);
+        CHECK(sameElements(grown.get(0), small.get(0)));
+        SquareMatBatchI64 shrunk(2, 1);
+        shrunk = large;
+        CHECK(shrunk.count() == 100);
+        CHECK(sameElements(shrunk.get(99), patternMatrix<std::int64_t>(4, 3)));
+        SquareMatBatchI64 moved(3, 9, &counter);
+        moved = std::move(large);
+        CHECK(moved.planePitch() == shrunk.planePitch());
+        CHECK(sameElements(moved.get(99), patternMatrix<std::int64_t>(4, 3)));
+    }
+    
+    SUBCASE("Batched operators match per-matrix results") {
+        for (int n : {1, 2, 3, 4, 5}) {
+            CAPTURE(n);
+            const int count = 19;
+            SquareMatBatchI64 a(n, count);
+            SquareMatBatchI64 b(n, count);
+            for (int k = 0; k < count; ++k) {
+                a.set(k, patternMatrix<std::int64_t>(n, k));
+                b.set(k, patternMatrix<std::int64_t>(n, 2 * k + 1));
+            }
+            SquareMatBatchI64 product = a * b;
+            SquareMatBatchI64 sum = a + b;
+            SquareMatBatchI64 transposed = ~a;
+            VectorI64 determinants = !a;
+            for (int k = 0; k < count; ++k) {
+                CAPTURE(k);
+                SquareMatI64 ak = a.get(k);
+                SquareMatI64 bk = b.get(k);
+                CHECK(sameElements(product.get(k), naiveProduct(ak, bk)));
+                CHECK(sameElements(sum.get(k), ak + bk));
+                CHECK(sameElements(transposed.get(k), ~ak));
+                CHECK(determinants[k] == !ak);
+            }
+        }
+    }
+    
+    SUBCASE("Determinants of known 4x4 matrices") {
+        SquareMatBatch batch(4, 2);
+        batch.set(0, SquareMat::identity(4) * 2.0);
+        SquareMat m(4);
+        double values[4][4] = {{1, 2, 3, 4}, {5, 6, 7, 8}, {2, 6, 4, 8}, {3, 1, 1, 2}};
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                m[i][j] = values[i][j];
+            }
+        }
+        batch.set(1, m);
+        Vector determinants = !batch;
+        CHECK(determinants[0] == Approx(16.0));
+        CHECK(determinants[1] == Approx(!m));
+        CHECK(determinants[1] == Approx(72.0));
+    }
+}